@@ -0,0 +1,525 @@
+#include <algorithm> // std::copy, std::fill, std::find, std::inplace_merge, std::min, std::sort
+#include <chrono> // std::chrono::steady_clock
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <fstream> // std::ofstream
+#include <iostream> // std::cout, std::cerr, std::endl
+#include <iterator> // std::make_move_iterator
+#include <limits> // std::numeric_limits
+#include <numeric> // std::accumulate
+#include <string> // std::string, std::stoul
+#include <thread> // std::thread::hardware_concurrency
+#include <vector> // std::vector
+
+#include <omp.h> // omp_set_num_threads
+#include <parallel/algorithm> // __gnu_parallel::count, __gnu_parallel::sort, __gnu_parallel::sequential_tag
+
+#include <stations/internal/algorithm_help_functions.hpp> // stations_internal::get_grain_size
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+#include <stations/algorithm.hpp> // stations::all_of, stations::any_of, stations::count, stations::fill, stations::sort
+#include <stations/join.hpp> // stations::join
+#include <stations/split.hpp> // stations::split
+#include <stations/station_options.hpp> // stations::StationOptions
+
+
+/** What to run, set on the command line. */
+struct Config
+{
+  std::size_t min_exponent = 3; /** Smallest size is 10^min_exponent elements */
+  std::size_t max_exponent = 8; /** Largest size is 10^max_exponent elements */
+  std::vector<std::size_t> thread_counts;
+  std::vector<std::size_t> chunk_sizes; /** 0 is the grain size the algorithms use by default */
+  std::size_t repetitions = 10;
+  std::size_t warmup = 2;
+  std::vector<std::string> algorithms;
+  std::string format = "csv";
+  std::string output; /** Standard output if empty */
+};
+
+
+/** The times of one implementation of an algorithm, for one size, thread count and chunk size. */
+struct Result
+{
+  std::string algorithm;
+  std::string implementation;
+  std::size_t size;
+  std::size_t threads;
+  std::size_t chunk_size;
+  std::vector<double> seconds; /** Time of each repetition, sorted */
+
+  double get_median() const;
+  double get_p95() const;
+  double get_mean() const;
+};
+
+
+double
+Result::get_median() const
+{
+  std::size_t const n = seconds.size();
+  return n % 2 == 1 ? seconds[n / 2] : (seconds[n / 2 - 1] + seconds[n / 2]) / 2.0;
+}
+
+
+/** Nearest-rank percentile, the smallest time which at least 95% of the repetitions did not exceed. */
+double
+Result::get_p95() const
+{
+  std::size_t const rank = (seconds.size() * 95 + 99) / 100;
+  return seconds[std::max(rank, static_cast<std::size_t>(1)) - 1];
+}
+
+
+double
+Result::get_mean() const
+{
+  return std::accumulate(seconds.begin(), seconds.end(), 0.0) / seconds.size();
+}
+
+
+/** Returns the number of seconds it took to run the function. */
+template <typename TFunction>
+double
+get_seconds(TFunction function)
+{
+  auto t1 = std::chrono::steady_clock::now();
+  function();
+  auto t2 = std::chrono::steady_clock::now();
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+/** Adds results to the results in all benchmarks, so the compiler cannot drop the work. */
+std::uint64_t checksum = 0;
+
+
+/** Runs the setup and then the timed function, first warmup times without recording and then repetitions times. */
+template <typename TSetup, typename TRun>
+Result
+measure(Config const & config,
+        std::string const & algorithm,
+        std::string const & implementation,
+        std::size_t const size,
+        std::size_t const threads,
+        std::size_t const chunk_size,
+        TSetup setup,
+        TRun run)
+{
+  Result result;
+  result.algorithm = algorithm;
+  result.implementation = implementation;
+  result.size = size;
+  result.threads = threads;
+  result.chunk_size = chunk_size;
+
+  for (std::size_t r = 0; r < config.warmup; ++r)
+  {
+    setup();
+    run();
+  }
+
+  for (std::size_t r = 0; r < config.repetitions; ++r)
+  {
+    setup();
+    result.seconds.push_back(get_seconds(run));
+  }
+
+  std::sort(result.seconds.begin(), result.seconds.end());
+  std::cerr << algorithm << " " << implementation << " size=" << size << " threads=" << threads << " chunk_size="
+            << chunk_size << " median=" << result.get_median() << "\n";
+  return result;
+}
+
+
+/**
+ * Measures one algorithm on one size. The serial std version runs once, the parallel ones with every thread count,
+ * and stations also with every chunk size. run_gnu and run_omp get the number of threads, run_stations gets the
+ * options. __gnu_parallel uses as many threads as OpenMP is set to.
+ */
+template <typename TSetup, typename TStd, typename TGnu, typename TOmp, typename TStations>
+void
+benchmark_algorithm(Config const & config,
+                    std::string const & algorithm,
+                    std::size_t const size,
+                    std::vector<Result> & results,
+                    TSetup setup,
+                    TStd run_std,
+                    TGnu run_gnu,
+                    TOmp run_omp,
+                    TStations run_stations,
+                    bool const has_gnu_version = true,
+                    bool const has_chunks = true)
+{
+  if (std::find(config.algorithms.begin(), config.algorithms.end(), algorithm) == config.algorithms.end())
+    return;
+
+  results.push_back(measure(config, algorithm, "std", size, 1, 0, setup, run_std));
+
+  for (std::size_t const threads : config.thread_counts)
+  {
+    if (has_gnu_version)
+    {
+      omp_set_num_threads(threads);
+      results.push_back(measure(config, algorithm, "gnu_parallel", size, threads, 0, setup, run_gnu));
+    }
+
+    results.push_back(measure(config, algorithm, "openmp", size, threads, 0, setup, [&run_omp, threads]{
+        run_omp(threads);
+      }));
+
+    std::vector<std::size_t> const no_chunks(1, 0);
+
+    for (std::size_t const chunk_size : has_chunks ? config.chunk_sizes : no_chunks)
+    {
+      stations::StationOptions options;
+      options.set_num_threads(threads);
+      options.chunk_size = chunk_size > 0 ? chunk_size : stations_internal::get_grain_size(size, threads);
+
+      results.push_back(measure(config, algorithm, "stations", size, threads, has_chunks ? options.chunk_size : 0,
+                                setup, [&run_stations, &options]{
+          run_stations(stations::StationOptions(options));
+        }));
+    }
+  }
+}
+
+
+/** Sorts num_parts partitions in parallel and merges neighbouring runs in parallel rounds. */
+void
+omp_sort(std::vector<int>::iterator first, std::size_t const size, std::size_t const num_parts)
+{
+  std::vector<std::size_t> bounds;
+
+  for (std::size_t p = 0; p <= num_parts; ++p)
+    bounds.push_back(size * p / num_parts);
+
+  #pragma omp parallel for num_threads(num_parts)
+  for (long p = 0; p < static_cast<long>(num_parts); ++p)
+    __gnu_parallel::sort(first + bounds[p], first + bounds[p + 1], __gnu_parallel::sequential_tag());
+
+  for (std::size_t width = 1; width < num_parts; width *= 2)
+  {
+    #pragma omp parallel for num_threads(num_parts)
+    for (long r = 0; r < static_cast<long>((num_parts + width - 1) / (2 * width)); ++r)
+    {
+      std::size_t const p = r * 2 * width;
+      std::inplace_merge(first + bounds[p], first + bounds[p + width],
+                         first + bounds[std::min(p + 2 * width, num_parts)]);
+    }
+  }
+}
+
+
+void
+run_benchmarks(Config const & config, std::vector<int> const & data, std::vector<Result> & results)
+{
+  std::vector<int> values(data);
+  auto no_setup = []{};
+  int const missing_value = std::numeric_limits<int>::min(); // Never generated, so the searches scan everything
+
+  for (std::size_t exponent = config.min_exponent; exponent <= config.max_exponent; ++exponent)
+  {
+    std::size_t size = 1;
+
+    for (std::size_t e = 0; e < exponent; ++e)
+      size *= 10;
+
+    auto const first = values.begin();
+    auto const last = values.begin() + size;
+    auto const is_present = [missing_value](int const v){return v != missing_value;};
+    auto const is_missing = [missing_value](int const v){return v == missing_value;};
+    auto const is_negative = [](int const v){return v < 0;};
+    auto const flip = [](int & v){v ^= 0x5a5a;};
+
+    // all_of and any_of find nothing which stops them early, which is their slowest case
+    benchmark_algorithm(config, "all_of", size, results, no_setup,
+      [&]{checksum += std::all_of(first, last, is_present);},
+      [&]{checksum += __gnu_parallel::find_if(first, last, is_missing) == last;},
+      [&](std::size_t const threads){
+        int result = 1;
+
+        #pragma omp parallel for num_threads(threads) reduction(&:result)
+        for (long i = 0; i < static_cast<long>(size); ++i)
+          result &= is_present(values[i]);
+
+        checksum += result;
+      },
+      [&](stations::StationOptions && options){checksum += stations::all_of(std::move(options), first, last, is_present);});
+
+    benchmark_algorithm(config, "any_of", size, results, no_setup,
+      [&]{checksum += std::any_of(first, last, is_missing);},
+      [&]{checksum += __gnu_parallel::find_if(first, last, is_missing) != last;},
+      [&](std::size_t const threads){
+        int result = 0;
+
+        #pragma omp parallel for num_threads(threads) reduction(|:result)
+        for (long i = 0; i < static_cast<long>(size); ++i)
+          result |= is_missing(values[i]);
+
+        checksum += result;
+      },
+      [&](stations::StationOptions && options){checksum += stations::any_of(std::move(options), first, last, is_missing);});
+
+    benchmark_algorithm(config, "count", size, results, no_setup,
+      [&]{checksum += __gnu_parallel::count(first, last, 0, __gnu_parallel::sequential_tag());},
+      [&]{checksum += __gnu_parallel::count(first, last, 0);},
+      [&](std::size_t const threads){
+        long result = 0;
+
+        #pragma omp parallel for num_threads(threads) reduction(+:result)
+        for (long i = 0; i < static_cast<long>(size); ++i)
+          result += values[i] == 0;
+
+        checksum += result;
+      },
+      [&](stations::StationOptions && options){checksum += stations::count(std::move(options), first, last, 0);});
+
+    benchmark_algorithm(config, "count_if", size, results, no_setup,
+      [&]{checksum += __gnu_parallel::count_if(first, last, is_negative, __gnu_parallel::sequential_tag());},
+      [&]{checksum += __gnu_parallel::count_if(first, last, is_negative);},
+      [&](std::size_t const threads){
+        long result = 0;
+
+        #pragma omp parallel for num_threads(threads) reduction(+:result)
+        for (long i = 0; i < static_cast<long>(size); ++i)
+          result += is_negative(values[i]);
+
+        checksum += result;
+      },
+      [&](stations::StationOptions && options){
+        checksum += stations::count_if(std::move(options), first, last, is_negative);
+      });
+
+    // __gnu_parallel has no fill, generate writes the same value
+    benchmark_algorithm(config, "fill", size, results, no_setup,
+      [&]{std::fill(first, last, 7);},
+      [&]{__gnu_parallel::generate(first, last, []{return 7;});},
+      [&](std::size_t const threads){
+        #pragma omp parallel for num_threads(threads)
+        for (long i = 0; i < static_cast<long>(size); ++i)
+          values[i] = 7;
+      },
+      [&](stations::StationOptions && options){stations::fill(std::move(options), first, last, 7);});
+
+    // Put the random values back after fill
+    std::copy(data.begin(), data.begin() + size, values.begin());
+
+    benchmark_algorithm(config, "for_each", size, results, no_setup,
+      [&]{__gnu_parallel::for_each(first, last, flip, __gnu_parallel::sequential_tag());},
+      [&]{__gnu_parallel::for_each(first, last, flip);},
+      [&](std::size_t const threads){
+        #pragma omp parallel for num_threads(threads)
+        for (long i = 0; i < static_cast<long>(size); ++i)
+          flip(values[i]);
+      },
+      [&](stations::StationOptions && options){stations::for_each(std::move(options), first, last, flip);});
+
+    // Every repetition sorts the same random values, copying them is not timed
+    auto const restore = [&]{std::copy(data.begin(), data.begin() + size, values.begin());};
+
+    benchmark_algorithm(config, "sort", size, results, restore,
+      [&]{__gnu_parallel::sort(first, last, __gnu_parallel::sequential_tag());},
+      [&]{__gnu_parallel::sort(first, last);},
+      [&](std::size_t const threads){omp_sort(first, size, threads);},
+      [&](stations::StationOptions && options){stations::sort(std::move(options), first, last);});
+
+    // Splits the values into one part for each thread and joins them back, __gnu_parallel has nothing like it
+    std::vector<int> container;
+    auto const restore_container = [&]{container.assign(data.begin(), data.begin() + size);};
+
+    benchmark_algorithm(config, "split_join", size, results, restore_container,
+      [&]{
+        std::vector<int> part(std::make_move_iterator(container.begin()), std::make_move_iterator(container.end()));
+        container.clear();
+        container.insert(container.end(), part.begin(), part.end());
+        checksum += container.size();
+      },
+      []{},
+      [&](std::size_t const threads){
+        std::vector<std::vector<int> > parts(threads);
+
+        #pragma omp parallel for num_threads(threads)
+        for (long p = 0; p < static_cast<long>(threads); ++p)
+        {
+          parts[p].assign(std::make_move_iterator(container.begin() + size * p / threads),
+                          std::make_move_iterator(container.begin() + size * (p + 1) / threads));
+        }
+
+        #pragma omp parallel for num_threads(threads)
+        for (long p = 0; p < static_cast<long>(threads); ++p)
+          std::copy(parts[p].begin(), parts[p].end(), container.begin() + size * p / threads);
+
+        checksum += container.size();
+      },
+      [&](stations::StationOptions && options){
+        auto parts = stations::split(container.begin(), container.end(), options);
+        container.clear();
+        stations::join(container, parts);
+        checksum += container.size();
+      },
+      false /*has_gnu_version*/,
+      false /*has_chunks*/);
+  }
+}
+
+
+void
+write_csv(std::ostream & out, std::vector<Result> const & results)
+{
+  out << "algorithm,implementation,size,threads,chunk_size,repetitions,median_s,p95_s,min_s,mean_s,"
+      << "elements_per_s\n";
+
+  for (auto const & r : results)
+  {
+    out << r.algorithm << "," << r.implementation << "," << r.size << "," << r.threads << "," << r.chunk_size << ","
+        << r.seconds.size() << "," << r.get_median() << "," << r.get_p95() << "," << r.seconds.front() << ","
+        << r.get_mean() << "," << r.size / r.get_median() << "\n";
+  }
+}
+
+
+void
+write_json(std::ostream & out, std::vector<Result> const & results)
+{
+  out << "[";
+
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    Result const & r = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "  {\"algorithm\": \"" << r.algorithm << "\", \"implementation\": \""
+        << r.implementation << "\", \"size\": " << r.size << ", \"threads\": " << r.threads << ", \"chunk_size\": "
+        << r.chunk_size << ", \"repetitions\": " << r.seconds.size() << ", \"median_s\": " << r.get_median()
+        << ", \"p95_s\": " << r.get_p95() << ", \"min_s\": " << r.seconds.front() << ", \"mean_s\": " << r.get_mean()
+        << ", \"elements_per_s\": " << r.size / r.get_median() << "}";
+  }
+
+  out << "\n]\n";
+}
+
+
+/** Parses a comma separated list, where "auto" is 0. */
+std::vector<std::size_t>
+parse_numbers(std::string const & list)
+{
+  std::vector<std::size_t> numbers;
+  std::size_t pos = 0;
+
+  while (pos <= list.size())
+  {
+    std::size_t const end = std::min(list.find(',', pos), list.size());
+    std::string const number = list.substr(pos, end - pos);
+
+    if (number == "auto")
+      numbers.push_back(0);
+    else if (!number.empty())
+      numbers.push_back(std::stoul(number));
+
+    pos = end + 1;
+  }
+
+  return numbers;
+}
+
+
+std::vector<std::string>
+parse_names(std::string const & list)
+{
+  std::vector<std::string> names;
+  std::size_t pos = 0;
+
+  while (pos <= list.size())
+  {
+    std::size_t const end = std::min(list.find(',', pos), list.size());
+
+    if (end > pos)
+      names.push_back(list.substr(pos, end - pos));
+
+    pos = end + 1;
+  }
+
+  return names;
+}
+
+
+int
+main(int argc, char ** argv)
+{
+  Config config;
+  std::size_t const max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2)
+    config.thread_counts.push_back(threads);
+
+  config.thread_counts.push_back(max_threads);
+  config.chunk_sizes = parse_numbers("auto,4096,65536");
+  config.algorithms = parse_names("all_of,any_of,count,count_if,fill,for_each,sort,split_join");
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string const arg = argv[i];
+
+    if (arg == "--help" || i + 1 == argc)
+    {
+      std::cerr << "Usage: " << argv[0] << " [--OPTION VALUE]...\n"
+                << "  --min-exponent N  Smallest size is 10^N elements (default 3)\n"
+                << "  --max-exponent N  Largest size is 10^N elements (default 8). 9 needs about 12 GB for sort.\n"
+                << "  --threads LIST    Thread counts, e.g. 1,2,4,8 (default powers of 2 up to the number of cores)\n"
+                << "  --chunk-sizes LIST  Chunk sizes of stations, auto is the default grain size "
+                << "(default auto,4096,65536)\n"
+                << "  --repetitions N   Timed runs of each benchmark (default 10)\n"
+                << "  --warmup N        Untimed runs before them (default 2)\n"
+                << "  --algorithms LIST Any of all_of,any_of,count,count_if,fill,for_each,sort,split_join (default all)\n"
+                << "  --format FORMAT   csv or json (default csv)\n"
+                << "  --output FILE     Where to write the results (default standard output)\n";
+      return arg == "--help" ? 0 : 1;
+    }
+
+    std::string const value = argv[++i];
+
+    if (arg == "--min-exponent")
+      config.min_exponent = std::stoul(value);
+    else if (arg == "--max-exponent")
+      config.max_exponent = std::stoul(value);
+    else if (arg == "--threads")
+      config.thread_counts = parse_numbers(value);
+    else if (arg == "--chunk-sizes")
+      config.chunk_sizes = parse_numbers(value);
+    else if (arg == "--repetitions")
+      config.repetitions = std::max(1ul, std::stoul(value));
+    else if (arg == "--warmup")
+      config.warmup = std::stoul(value);
+    else if (arg == "--algorithms")
+      config.algorithms = parse_names(value);
+    else if (arg == "--format")
+      config.format = value;
+    else if (arg == "--output")
+      config.output = value;
+    else
+      std::cerr << "Unknown option " << arg << ", use --help to list the options\n";
+  }
+
+  // Setup, the same random values are used by every benchmark
+  srand(42);
+  std::size_t max_size = 1;
+
+  for (std::size_t e = 0; e < config.max_exponent; ++e)
+    max_size *= 10;
+
+  std::vector<int> const data = stations_internal::get_random_ints<std::vector<int> >(max_size);
+  std::vector<Result> results;
+  run_benchmarks(config, data, results);
+
+  std::ofstream output_file;
+
+  if (!config.output.empty())
+    output_file.open(config.output);
+
+  std::ostream & out = config.output.empty() ? std::cout : output_file;
+
+  if (config.format == "json")
+    write_json(out, results);
+  else
+    write_csv(out, results);
+
+  std::cerr << "Checksum " << checksum << std::endl;
+}
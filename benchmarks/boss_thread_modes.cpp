@@ -0,0 +1,84 @@
+#include <chrono> // std::chrono::system_clock::now
+#include <iostream> // std::cout, std::endl;
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+#include <stations/station.hpp> // stations::Station
+#include <stations/station_options.hpp> // stations::StationOptions
+
+#include "help_functions.hpp"
+
+
+std::size_t
+count_primes(std::vector<int> const & ints, std::size_t const first, std::size_t const last)
+{
+  std::size_t primes = 0;
+
+  for (std::size_t j = first; j < last; ++j)
+    primes += is_prime(std::abs(ints[j]));
+
+  return primes;
+}
+
+
+/** The producer does `producer_cost` units of work before adding each job, and each job does `job_cost` units. */
+double
+run_boss_thread_mode(std::vector<int> const & ints,
+                     stations::BOSS_THREAD_MODE const boss_thread_mode,
+                     std::size_t const producer_cost,
+                     std::size_t const job_cost)
+{
+  std::size_t const NUM_JOBS = ints.size() / std::max(producer_cost, job_cost);
+  stations::StationOptions options;
+  options.num_threads = 8;
+  options.boss_thread_mode = boss_thread_mode;
+  volatile std::size_t primes = 0;
+
+  auto t1 = std::chrono::system_clock::now();
+
+  {
+    stations::Station station(options);
+
+    for (std::size_t i = 0; i < NUM_JOBS; ++i)
+    {
+      // Simulate the producer reading input, e.g. parsing a file
+      primes = primes + count_primes(ints, i * producer_cost, (i + 1) * producer_cost);
+
+      station.add_work([&ints, &primes, job_cost](std::size_t const first){
+          primes = primes + count_primes(ints, first, first + job_cost);
+        }, i * job_cost);
+    }
+
+    station.join();
+  }
+
+  auto t2 = std::chrono::system_clock::now();
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+int
+main()
+{
+  // Parameters
+  std::size_t SEED = 42;
+  std::size_t const N = 4000000;
+
+  // Setup
+  srand(SEED);
+  std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(N);
+
+  std::vector<std::pair<char const *, stations::BOSS_THREAD_MODE> > const modes = {
+    {"Hard working boss", stations::HARD_WORKING_BOSS},
+    {"Patient boss", stations::PATIENT_BOSS},
+    {"Organized boss", stations::ORGANIZED_BOSS}
+  };
+
+  // Benchmark starts here
+  for (auto const & mode : modes)
+  {
+    std::cout << mode.first << "\n"
+              << "  producer-bound: " << run_boss_thread_mode(ints, mode.second, 1000 /*producer_cost*/, 100 /*job_cost*/) << "\n"
+              << "  consumer-bound: " << run_boss_thread_mode(ints, mode.second, 10 /*producer_cost*/, 1000 /*job_cost*/) << "\n";
+  }
+}
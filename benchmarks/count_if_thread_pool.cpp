@@ -0,0 +1,109 @@
+#include <algorithm> // std::count_if
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::system_clock::now
+#include <iostream> // std::cout, std::endl;
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+#include <stations/algorithm.hpp> // stations::count_if
+#include <stations/station_options.hpp> // stations::StationOptions
+#include <stations/thread_pool.hpp> // stations::PooledStation
+
+
+/** Calls count_if many times on a small vector, where starting and joining threads would dominate. */
+double
+run_many_count_ifs(std::vector<int> const & ints, std::size_t const CALLS, bool const use_thread_pool)
+{
+  std::size_t total_count = 0;
+  auto t1 = std::chrono::system_clock::now();
+
+  for (std::size_t i = 0; i < CALLS; ++i)
+  {
+    stations::StationOptions options;
+    options.num_threads = 8;
+    options.use_thread_pool = use_thread_pool;
+    total_count += stations::count_if(std::move(options), ints.begin(), ints.end(), [](int n){return n < 0;});
+  }
+
+  auto t2 = std::chrono::system_clock::now();
+  std::cout << "Total count " << total_count << "\n";
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+/** Counts like count_if from several threads at the same time, each with its own options if different_options is set,
+ *  and prints how often a caller did not get a station from the pool and had to start its own threads.
+ */
+double
+run_concurrent_count_ifs(std::vector<int> const & ints, std::size_t const CALLS, std::size_t const CALLERS,
+                         bool const different_options)
+{
+  std::atomic<std::size_t> total_count(0);
+  std::atomic<std::size_t> num_unpooled(0);
+  std::vector<std::thread> callers;
+  auto t1 = std::chrono::system_clock::now();
+
+  for (std::size_t c = 0; c < CALLERS; ++c)
+  {
+    callers.push_back(std::thread([&, c]{
+        for (std::size_t i = 0; i < CALLS / CALLERS; ++i)
+        {
+          stations::StationOptions options;
+          options.num_threads = different_options ? 2 + c : 4;
+          stations::PooledStation station(options);
+          num_unpooled += station.is_pooled() ? 0 : 1;
+          std::size_t const part_size = ints.size() / options.num_threads;
+
+          for (std::size_t p = 0; p < options.num_threads; ++p)
+          {
+            station.add_work([&total_count](std::vector<int>::const_iterator first,
+                                            std::vector<int>::const_iterator last)
+              {
+                total_count += std::count_if(first, last, [](int n){return n < 0;});
+              }, ints.begin() + p * part_size, p + 1 == options.num_threads ? ints.end() :
+                                                                              ints.begin() + (p + 1) * part_size);
+          }
+
+          station.join();
+        }
+      }));
+  }
+
+  for (auto & caller : callers)
+    caller.join();
+
+  auto t2 = std::chrono::system_clock::now();
+  std::cout << "Total count " << total_count << ", " << num_unpooled << " of " << (CALLS / CALLERS * CALLERS)
+            << " calls started their own threads\n";
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+int
+main()
+{
+  // Parameters
+  std::size_t SEED = 42;
+  std::size_t const N = 10000;
+  std::size_t const CALLS = 100000;
+
+  // Setup
+  srand(SEED);
+  std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(N);
+
+  // Benchmark starts here
+  double const pooled_time = run_many_count_ifs(ints, CALLS, true /*use_thread_pool*/);
+  double const unpooled_time = run_many_count_ifs(ints, CALLS, false /*use_thread_pool*/);
+
+  std::cout << "With thread pool: " << pooled_time << "\n"
+            << "Without thread pool: " << unpooled_time << "\n";
+
+  // Callers with their own options each get their own station from the pool, callers with the same options share one
+  std::size_t const CALLERS = 4;
+  double const different_options_time = run_concurrent_count_ifs(ints, CALLS / 10, CALLERS, true);
+  double const same_options_time = run_concurrent_count_ifs(ints, CALLS / 10, CALLERS, false);
+
+  std::cout << CALLERS << " concurrent callers with different options: " << different_options_time << "\n"
+            << CALLERS << " concurrent callers with the same options: " << same_options_time << "\n";
+}
@@ -0,0 +1,73 @@
+#include <algorithm> // std::find_if, std::min_element, std::max_element, std::minmax_element
+#include <chrono> // std::chrono::system_clock::now
+#include <iostream> // std::cout, std::endl;
+#include <parallel/algorithm> // __gnu_parallel::find_if, __gnu_parallel::min_element, __gnu_parallel::max_element
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+#include <stations/algorithm.hpp> // stations::find_if, stations::min_element, stations::max_element
+#include <stations/station_options.hpp> // stations::StationOptions
+
+
+/** Returns the number of seconds it took to run the function. */
+template <typename TFunction>
+double
+get_seconds(TFunction function)
+{
+  auto t1 = std::chrono::system_clock::now();
+  function();
+  auto t2 = std::chrono::system_clock::now();
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+int
+main()
+{
+  // Parameters
+  std::size_t SEED = 42;
+  std::size_t const N = 100000000;
+
+  // Setup
+  srand(SEED);
+  std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(N);
+  ints[N * 3 / 4] = 0; // The value to find, in the last quarter so there is something to skip
+  auto is_zero = [](int n){return n == 0;};
+  std::size_t checksum = 0;
+
+  std::cout << "find_if:\n";
+  std::cout << "  stations: " << get_seconds([&]{
+      checksum += stations::find_if(ints.begin(), ints.end(), is_zero) - ints.begin();
+    }) << "\n";
+  std::cout << "  gnu:      " << get_seconds([&]{
+      checksum += __gnu_parallel::find_if(ints.begin(), ints.end(), is_zero) - ints.begin();
+    }) << "\n";
+
+  std::cout << "min_element:\n";
+  std::cout << "  stations: " << get_seconds([&]{
+      checksum += *stations::min_element(ints.begin(), ints.end());
+    }) << "\n";
+  std::cout << "  gnu:      " << get_seconds([&]{
+      checksum += *__gnu_parallel::min_element(ints.begin(), ints.end());
+    }) << "\n";
+
+  std::cout << "max_element:\n";
+  std::cout << "  stations: " << get_seconds([&]{
+      checksum += *stations::max_element(ints.begin(), ints.end());
+    }) << "\n";
+  std::cout << "  gnu:      " << get_seconds([&]{
+      checksum += *__gnu_parallel::max_element(ints.begin(), ints.end());
+    }) << "\n";
+
+  // __gnu_parallel has no minmax_element, so compare to the serial std::minmax_element
+  std::cout << "minmax_element:\n";
+  std::cout << "  stations: " << get_seconds([&]{
+      auto const minmax = stations::minmax_element(ints.begin(), ints.end());
+      checksum += *minmax.first + *minmax.second;
+    }) << "\n";
+  std::cout << "  std:      " << get_seconds([&]{
+      auto const minmax = std::minmax_element(ints.begin(), ints.end());
+      checksum += *minmax.first + *minmax.second;
+    }) << "\n";
+
+  std::cout << "Checksum " << checksum << std::endl;
+}
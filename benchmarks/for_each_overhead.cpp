@@ -0,0 +1,53 @@
+#include <chrono> // std::chrono::system_clock::now
+#include <iostream> // std::cout, std::endl;
+#include <vector> // std::vector
+
+#include <stations/algorithm.hpp> // stations::for_each
+#include <stations/station_options.hpp> // stations::StationOptions
+
+
+/** Returns the number of nanoseconds per element it took to run the function. */
+template <typename TFunction>
+double
+get_ns_per_element(std::size_t const N, TFunction function)
+{
+  auto t1 = std::chrono::system_clock::now();
+  function();
+  auto t2 = std::chrono::system_clock::now();
+  return static_cast<std::chrono::duration<double, std::nano> >(t2 - t1).count() / N;
+}
+
+
+int
+main()
+{
+  // Parameters
+  std::size_t const N = 100000000;
+  std::size_t const N_PER_ELEMENT_JOBS = 1000000; // One job per element is too slow for all N elements
+  std::vector<float> values(N, 1.0f);
+  auto scale = [](float & value){value = value * 1.0001f + 0.5f;};
+
+  // Serial loop
+  double const serial_ns = get_ns_per_element(N, [&]{
+      for (auto & value : values)
+        scale(value);
+    });
+
+  std::cout << "Serial loop:              " << serial_ns << " ns per element\n";
+
+  // Chunks with an automatic grain size
+  double const chunked_ns = get_ns_per_element(N, [&]{
+      stations::for_each(values.begin(), values.end(), scale);
+    });
+
+  std::cout << "for_each, automatic grain: " << chunked_ns << " ns per element\n";
+
+  // One job per element, like for_each used to do
+  double const per_element_ns = get_ns_per_element(N_PER_ELEMENT_JOBS, [&]{
+      stations::StationOptions options;
+      options.chunk_size = 1;
+      stations::for_each(std::move(options), values.begin(), values.begin() + N_PER_ELEMENT_JOBS, scale);
+    });
+
+  std::cout << "for_each, one job each:    " << per_element_ns << " ns per element" << std::endl;
+}
@@ -0,0 +1,140 @@
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::system_clock::now
+#include <cstdint> // int64_t
+#include <cstdlib> // std::malloc, std::free
+#include <iostream> // std::cout, std::endl
+#include <new> // std::bad_alloc
+#include <string> // std::stoul
+#include <vector> // std::vector
+
+#include <stations/chunk_pool.hpp> // stations::ChunkPool, stations::PooledChunk
+#include <stations/pipeline.hpp> // stations::run_pipeline
+
+#include "help_functions.hpp"
+
+
+/** Number of calls to operator new in the whole program. */
+std::atomic<std::size_t> num_allocations(0);
+
+
+void *
+operator new(std::size_t size)
+{
+  ++num_allocations;
+
+  if (void * p = std::malloc(size == 0 ? 1 : size))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+
+void
+operator delete(void * p) noexcept
+{
+  std::free(p);
+}
+
+
+/** Returns the number of seconds it took to run the function. */
+template <typename TFunction>
+double
+get_seconds(TFunction function)
+{
+  auto t1 = std::chrono::system_clock::now();
+  function();
+  auto t2 = std::chrono::system_clock::now();
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+/** Keeps the primes of the chunk, like the example which reads ints and keeps the primes only. */
+template <typename TChunk>
+TChunk
+keep_primes(TChunk && chunk)
+{
+  std::size_t num_primes = 0;
+
+  for (int const i : *chunk)
+  {
+    if (is_prime(i))
+      (*chunk)[num_primes++] = i;
+  }
+
+  chunk->resize(num_primes);
+  return std::move(chunk);
+}
+
+
+int
+main(int argc, char ** argv)
+{
+  // Parameters
+  std::size_t const NUM_CHUNKS = argc > 1 ? std::stoul(argv[1]) : 100000;
+  std::size_t const CHUNK_SIZE = 4096;
+  std::size_t const NUM_THREADS = 8;
+
+  stations::StationOptions options;
+  options.set_num_threads(NUM_THREADS);
+  options.use_thread_pool = false;
+
+  // A new vector for every chunk, as when ReadIntegersFromFile returned a new vector
+  {
+    std::size_t num_read = 0;
+    std::size_t num_primes = 0;
+    std::size_t allocations_before = 0;
+
+    double const seconds = get_seconds([&]{
+        stations::run_pipeline<std::unique_ptr<std::vector<int> > >(
+          stations::StationOptions(options),
+          [&](std::unique_ptr<std::vector<int> > & chunk){
+            if (num_read == NUM_CHUNKS / 2)
+              allocations_before = num_allocations;
+
+            chunk.reset(new std::vector<int>());
+            chunk->reserve(CHUNK_SIZE);
+
+            for (std::size_t i = 0; i < CHUNK_SIZE; ++i)
+              chunk->push_back(static_cast<int>(num_read * CHUNK_SIZE + i));
+
+            return ++num_read <= NUM_CHUNKS;
+          },
+          keep_primes<std::unique_ptr<std::vector<int> > >,
+          [&](std::unique_ptr<std::vector<int> > && primes){num_primes += primes->size();});
+      });
+
+    std::cout << "New vector per chunk:  " << seconds << " seconds, " << num_primes << " primes, "
+              << static_cast<double>(num_allocations - allocations_before) / (NUM_CHUNKS / 2)
+              << " allocations per chunk in the second half of the stream\n";
+  }
+
+  // Vectors from a chunk pool, which are given back when the sink drops them
+  {
+    stations::ChunkPool<int> pool(NUM_THREADS * options.max_queue_size + 1, CHUNK_SIZE);
+    std::size_t num_read = 0;
+    std::size_t num_primes = 0;
+    std::size_t allocations_before = 0;
+
+    double const seconds = get_seconds([&]{
+        stations::run_pipeline<stations::PooledChunk<int> >(
+          stations::StationOptions(options),
+          [&](stations::PooledChunk<int> & chunk){
+            if (num_read == NUM_CHUNKS / 2)
+              allocations_before = num_allocations;
+
+            chunk = pool.acquire();
+
+            for (std::size_t i = 0; i < CHUNK_SIZE; ++i)
+              chunk->push_back(static_cast<int>(num_read * CHUNK_SIZE + i));
+
+            return ++num_read <= NUM_CHUNKS;
+          },
+          keep_primes<stations::PooledChunk<int> >,
+          [&](stations::PooledChunk<int> && primes){num_primes += primes->size();});
+      });
+
+    std::cout << "Chunks from a pool:    " << seconds << " seconds, " << num_primes << " primes, "
+              << static_cast<double>(num_allocations - allocations_before) / (NUM_CHUNKS / 2)
+              << " allocations per chunk in the second half of the stream" << std::endl;
+  }
+}
@@ -0,0 +1,60 @@
+#include <chrono> // std::chrono::system_clock::now
+#include <cstdint> // std::uint64_t
+#include <iostream> // std::cout, std::endl;
+#include <parallel/numeric> // __gnu_parallel::partial_sum
+#include <string> // std::stoul
+#include <vector> // std::vector
+
+#include <stations/numeric.hpp> // stations::inclusive_scan
+
+
+/** Returns the number of seconds it took to run the function. */
+template <typename TFunction>
+double
+get_seconds(TFunction function)
+{
+  auto t1 = std::chrono::system_clock::now();
+  function();
+  auto t2 = std::chrono::system_clock::now();
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+int
+main(int argc, char ** argv)
+{
+  // Parameters, use e.g. 1000000000 on a machine with more than 8 GB of memory
+  std::size_t const N = argc > 1 ? std::stoul(argv[1]) : 100000000;
+
+  // Setup
+  std::vector<std::uint64_t> values(N);
+
+  for (std::size_t i = 0; i < N; ++i)
+    values[i] = i % 1000;
+
+  // Serial loop, in place
+  double const serial_seconds = get_seconds([&]{
+      for (std::size_t i = 1; i < N; ++i)
+        values[i] += values[i - 1];
+    });
+
+  std::cout << "Serial loop:    " << serial_seconds << " with last sum " << values.back() << "\n";
+
+  for (std::size_t i = 0; i < N; ++i)
+    values[i] = i % 1000;
+
+  double const gnu_seconds = get_seconds([&]{
+      __gnu_parallel::partial_sum(values.begin(), values.end(), values.begin(), std::plus<std::uint64_t>());
+    });
+
+  std::cout << "GNU parallel:   " << gnu_seconds << " with last sum " << values.back() << "\n";
+
+  for (std::size_t i = 0; i < N; ++i)
+    values[i] = i % 1000;
+
+  double const stations_seconds = get_seconds([&]{
+      stations::inclusive_scan(values.begin(), values.end(), values.begin());
+    });
+
+  std::cout << "stations:       " << stations_seconds << " with last sum " << values.back() << std::endl;
+}
@@ -0,0 +1,67 @@
+#include <chrono> // std::chrono::system_clock::now
+#include <iostream> // std::cout, std::endl;
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+#include <stations/station.hpp> // stations::Station
+#include <stations/station_options.hpp> // stations::StationOptions
+
+#include "help_functions.hpp"
+
+
+/** Runs chunks where every 16th chunk costs 16 times more than the others, like prime filtering of mixed input. */
+double
+run_skewed_chunks(std::vector<int> const & ints, stations::SCHEDULING_MODE const scheduling_mode)
+{
+  std::size_t const CHUNK_SIZE = 2000;
+  stations::StationOptions options;
+  options.num_threads = 8;
+  options.max_queue_size = 16;
+  options.scheduling_mode = scheduling_mode;
+
+  auto t1 = std::chrono::system_clock::now();
+
+  {
+    stations::Station station(options);
+
+    for (std::size_t i = 0, c = 0; i + CHUNK_SIZE <= ints.size(); i += CHUNK_SIZE, ++c)
+    {
+      std::size_t const repeats = c % 16 == 0 ? 16 : 1;
+
+      station.add_work([&ints, repeats](std::size_t const first, std::size_t const last){
+          volatile std::size_t primes = 0;
+
+          for (std::size_t r = 0; r < repeats; ++r)
+          {
+            for (std::size_t j = first; j < last; ++j)
+              primes = primes + is_prime(std::abs(ints[j]));
+          }
+        }, i, i + CHUNK_SIZE);
+    }
+
+    station.join();
+  }
+
+  auto t2 = std::chrono::system_clock::now();
+  return static_cast<std::chrono::duration<double> >(t2 - t1).count();
+}
+
+
+int
+main()
+{
+  // Parameters
+  std::size_t SEED = 42;
+  std::size_t const N = 2000000;
+
+  // Setup
+  srand(SEED);
+  std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(N);
+
+  // Benchmark starts here
+  double const static_time = run_skewed_chunks(ints, stations::STATIC_SCHEDULING);
+  double const stealing_time = run_skewed_chunks(ints, stations::WORK_STEALING);
+
+  std::cout << "Static scheduling: " << static_time << "\n"
+            << "Work stealing: " << stealing_time << "\n";
+}
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <bitset>
+#include <iomanip>
 #include <iostream>
 #include <stdlib.h>
 #include <vector>
@@ -13,17 +14,70 @@
 #include <stations/worker_queue.hpp>
 
 
+/** Sorts a copy of the ints with the given number of threads and returns the duration in seconds. */
+double
+sort_ints(std::vector<int> ints, std::size_t const num_threads)
+{
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+
+  auto start = std::chrono::system_clock::now();
+  stations::sort(std::move(options), ints.begin(), ints.end());
+  auto end = std::chrono::system_clock::now();
+
+  if (!std::is_sorted(ints.begin(), ints.end()))
+    std::cout << "NOT SORTED" << std::endl;
+
+  return static_cast<std::chrono::duration<double> >(end - start).count();
+}
+
+
+/** Reports how sorting scales with the number of threads, for sizes growing ten times from min_num_ints. */
+void
+report_scaling(std::size_t const min_num_ints, std::size_t const max_num_ints, std::size_t const max_threads)
+{
+  std::cout << std::setw(12) << "ints" << std::setw(10) << "threads"
+            << std::setw(12) << "seconds" << std::setw(10) << "speedup" << std::endl;
+
+  for (std::size_t num_ints = min_num_ints; num_ints <= max_num_ints; num_ints *= 10)
+  {
+    std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(num_ints);
+    double single_thread_seconds = 0.0;
+
+    for (std::size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+      double const seconds = sort_ints(ints, num_threads);
+
+      if (num_threads == 1)
+        single_thread_seconds = seconds;
+
+      std::cout << std::setw(12) << num_ints << std::setw(10) << num_threads
+                << std::setw(12) << seconds << std::setw(10) << single_thread_seconds / seconds << std::endl;
+    }
+  }
+}
+
+
 int
 main(int argc, char ** argv)
 {
   srand(42);  // Seed is 42
 
-  if (argc != 2)
+  if (argc != 2 && argc != 4)
   {
-    std::cerr << "Usage: " << argv[0] << " <NUM_INTS>" << std::endl;
+    std::cerr << "Usage: " << argv[0] << " <NUM_INTS> [<MAX_NUM_INTS> <MAX_THREADS>]\n"
+              << "With only NUM_INTS, sorts that many random ints once. With MAX_NUM_INTS and MAX_THREADS, reports how\n"
+              << "sorting scales from 1 to MAX_THREADS threads (doubling) for NUM_INTS up to MAX_NUM_INTS ints (ten times\n"
+              << "more each time), e.g. " << argv[0] << " 1000000 1000000000 64" << std::endl;
     std::exit(1);
   }
 
+  if (argc == 4)
+  {
+    report_scaling(std::stoul(argv[1]), std::stoul(argv[2]), std::stoul(argv[3]));
+    return 0;
+  }
+
   int const num_ints = std::stoi(argv[1]);
   // std::size_t num_threads = std::stoi(argv[2]);
 
@@ -1,12 +1,67 @@
 #pragma once
 
+#include <algorithm> // std::min
+#include <cstdio> // std::FILE, std::fopen, std::fread, std::fseek, std::ftell
+#include <cstring> // std::memchr, std::memmove
+#include <iostream> // std::cerr, std::endl
+#include <limits> // std::numeric_limits
+#include <memory> // std::shared_ptr, std::unique_ptr
 #include <string>
-#include <fstream>
+#include <vector>
+
+#include <stations/join.hpp> // stations::join
+#include <stations/station_options.hpp> // stations::StationOptions
+#include <stations/thread_pool.hpp> // stations::PooledStation
 
 namespace stations
 {
 
 
+/**
+ * Parses the integers on the lines which start in [first, lines_last) and end in [first, last), until the vector has
+ * max_size integers. The last line does not need a newline if is_end_of_file. Newlines are found with memchr, which is
+ * vectorized, and each digit costs a subtraction, a compare and a multiply-add. Lines without digits are skipped and
+ * anything after the digits, such as '\r', is ignored. Returns the start of the first line which was not parsed.
+ */
+inline
+char const *
+parse_integers(char const * first,
+               char const * last,
+               char const * lines_last,
+               bool const is_end_of_file,
+               std::vector<int> & integers,
+               std::size_t const max_size)
+{
+  while (first < lines_last && integers.size() < max_size)
+  {
+    char const * line_end = static_cast<char const *>(std::memchr(first, '\n', last - first));
+
+    if (line_end == nullptr)
+    {
+      if (!is_end_of_file)
+        break;
+
+      line_end = last;
+    }
+
+    bool const is_negative = *first == '-';
+    char const * it = first + is_negative;
+    unsigned value = 0;
+    unsigned digit;
+
+    for (; it != line_end && (digit = static_cast<unsigned>(*it - '0')) < 10; ++it)
+      value = value * 10 + digit;
+
+    if (it != first + is_negative)
+      integers.push_back(static_cast<int>(is_negative ? -static_cast<long>(value) : static_cast<long>(value)));
+
+    first = line_end == last ? last : line_end + 1;
+  }
+
+  return first;
+}
+
+
 /**
  * Interface
  */
@@ -14,25 +69,86 @@ class ReadIntegersFromFile
 {
  public:
   ReadIntegersFromFile(std::string const file_name);
+  ReadIntegersFromFile(std::string const file_name, std::size_t const first_byte, std::size_t const last_byte);
+  ~ReadIntegersFromFile();
+
   ReadIntegersFromFile & set_chunk_size(std::size_t const chunk_size);
   std::size_t get_chunk_size() const;
   std::shared_ptr<std::vector<int> > operator()();
+  bool operator()(std::vector<int> & integers);
 
  private:
-  std::ifstream file;
+  static std::size_t constexpr BLOCK_SIZE = 1 << 20; /** Number of bytes read from the file at a time */
+
+  std::FILE * file;
   std::size_t chunk_size;
+  std::unique_ptr<char[]> block;
+  std::size_t block_offset; /** Position of the start of the block in the file */
+  char const * parse_first; /** Start of the bytes in the block which have not been parsed */
+  char const * parse_last; /** End of the bytes which have been read into the block */
+  std::size_t last_byte; /** Lines which start at or after this position are left for another reader */
+  bool is_end_of_file;
+
+  bool read_block();
 };
 
 
+/** Reads all integers of the file with several threads. */
+std::vector<int> read_integers_in_parallel(std::string const & file_name, StationOptions && options);
+
+
 /**
  * Implementation
  */
 ReadIntegersFromFile::ReadIntegersFromFile(std::string const file_name)
-  : file(file_name.c_str())
-  , chunk_size(1000)
+  : ReadIntegersFromFile(file_name, 0, std::numeric_limits<std::size_t>::max())
 {}
 
 
+/** Reads only the lines which start in [first_byte, last_byte) of the file, so readers of neighbouring byte ranges
+ *  read every line once.
+ */
+ReadIntegersFromFile::ReadIntegersFromFile(std::string const file_name,
+                                           std::size_t const first_byte,
+                                           std::size_t const _last_byte)
+  : file(std::fopen(file_name.c_str(), "rb"))
+  , chunk_size(1000)
+  , block(new char[BLOCK_SIZE])
+  , block_offset(first_byte > 0 ? first_byte - 1 : 0)
+  , parse_first(block.get())
+  , parse_last(block.get())
+  , last_byte(_last_byte)
+  , is_end_of_file(file == nullptr)
+{
+  if (file && block_offset > 0)
+    std::fseek(file, block_offset, SEEK_SET);
+
+  // The line which ends right before first_byte belongs to the previous range, skip it
+  if (first_byte > 0)
+  {
+    while (read_block())
+    {
+      char const * newline = static_cast<char const *>(std::memchr(parse_first, '\n', parse_last - parse_first));
+
+      if (newline)
+      {
+        parse_first = newline + 1;
+        break;
+      }
+
+      parse_first = parse_last;
+    }
+  }
+}
+
+
+ReadIntegersFromFile::~ReadIntegersFromFile()
+{
+  if (file)
+    std::fclose(file);
+}
+
+
 ReadIntegersFromFile &
 ReadIntegersFromFile::set_chunk_size(std::size_t const _chunk_size)
 {
@@ -52,18 +168,107 @@ std::shared_ptr<std::vector<int> >
 ReadIntegersFromFile::operator()()
 {
   std::shared_ptr<std::vector<int> > integers = std::make_shared<std::vector<int> >();
-  integers->reserve(chunk_size);
+  (*this)(*integers);
+  return integers;
+}
+
+
+/** Reads the next chunk into the vector, so it can be used as the source of a pipeline. Returns false if there were no
+ *  integers left.
+ */
+bool
+ReadIntegersFromFile::operator()(std::vector<int> & integers)
+{
+  integers.clear();
+  integers.reserve(chunk_size);
+
+  while (integers.size() < chunk_size)
+  {
+    std::size_t const bytes_to_last = last_byte - std::min(last_byte, block_offset + (parse_first - block.get()));
+    char const * lines_last = parse_first + std::min(bytes_to_last, static_cast<std::size_t>(parse_last - parse_first));
+    parse_first = parse_integers(parse_first, parse_last, lines_last, is_end_of_file, integers, chunk_size);
+
+    if (integers.size() == chunk_size || (parse_first >= lines_last && lines_last < parse_last) || !read_block())
+      break;
+  }
+
+  return integers.size() > 0;
+}
+
+
+/** Moves the part of the last line which has not been parsed to the front of the block, and reads more bytes after it.
+ *  Returns false if nothing more could be read. Lines must fit in a block, a longer line is the last one read.
+ */
+bool
+ReadIntegersFromFile::read_block()
+{
+  if (is_end_of_file)
+    return false;
+
+  std::size_t const num_left = parse_last - parse_first;
+  block_offset += parse_first - block.get();
+  std::memmove(block.get(), parse_first, num_left);
+
+  if (num_left == BLOCK_SIZE)
+  {
+    // The line fills the whole block, so no more bytes fit after it. Parse it as the last line and stop reading.
+    std::cerr << "[stations] A line at byte " << block_offset << " is longer than " << BLOCK_SIZE
+              << " bytes, the rest of the file is not read." << std::endl;
+    is_end_of_file = true;
+    parse_first = block.get();
+    return true;
+  }
+
+  std::size_t const num_read = std::fread(block.get() + num_left, 1, BLOCK_SIZE - num_left, file);
+  is_end_of_file = num_read < BLOCK_SIZE - num_left;
+  parse_first = block.get();
+  parse_last = block.get() + num_left + num_read;
+  return num_read > 0 || num_left > 0;
+}
+
+
+/** Reads all integers of the file. Each thread reads and parses its own byte range of the file, and the parts are
+ *  joined in the order of the file.
+ */
+std::vector<int>
+read_integers_in_parallel(std::string const & file_name, StationOptions && options)
+{
+  std::size_t file_size = 0;
+  std::FILE * file = std::fopen(file_name.c_str(), "rb");
 
   if (file)
   {
-    std::string line;
+    std::fseek(file, 0, SEEK_END);
+    file_size = std::ftell(file);
+    std::fclose(file);
+  }
 
-    while (integers->size() < chunk_size and getline(file, line) and line.size() > 0)
-    {
-      integers->push_back(stoi(line));
-    }
+  std::size_t const num_parts = std::max(static_cast<std::size_t>(1), options.num_threads);
+  std::vector<std::shared_ptr<std::vector<int> > > parts;
+
+  for (std::size_t p = 0; p < num_parts; ++p)
+    parts.push_back(std::make_shared<std::vector<int> >());
+
+  stations::PooledStation read_station(options);
+
+  for (std::size_t p = 0; p < num_parts; ++p)
+  {
+    read_station.add_work([&file_name](std::size_t const first_byte, std::size_t const last_byte,
+                                       std::vector<int> * integers)
+      {
+        ReadIntegersFromFile riff(file_name, first_byte, last_byte);
+        riff.set_chunk_size(1 << 16);
+        std::vector<int> chunk;
+
+        while (riff(chunk))
+          integers->insert(integers->end(), chunk.begin(), chunk.end());
+      }, file_size * p / num_parts, file_size * (p + 1) / num_parts, parts[p].get());
   }
 
+  read_station.join();
+
+  std::vector<int> integers;
+  stations::join(integers, parts);
   return integers;
 }
 
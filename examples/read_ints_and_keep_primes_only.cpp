@@ -7,7 +7,10 @@
 #include <vector>
 
 
+#include <stations/algorithm.hpp>
+#include <stations/chunk_pool.hpp>
 #include <stations/join.hpp>
+#include <stations/pipeline.hpp>
 #include <stations/split.hpp>
 #include <stations/station.hpp>
 #include <stations/worker_queue.hpp>
@@ -38,26 +41,26 @@ is_prime(int const number)
 }
 
 
-void
-keep_primes(std::shared_ptr<std::vector<int> > numbers)
-{
-  numbers->erase(std::remove_if(numbers->begin(),
-                                numbers->end(),
-                                [](int const x){return !is_prime(x);}
-                               ),
-                 numbers->end()
-                 );
-}
-
-
 int main (int argc, char** argv)
 {
-  if (argc != 3)
+  if (argc != 3 && !(argc == 4 && std::string(argv[3]) == "--parallel-read"))
   {
-    std::cout << "Usage: " << argv[0] << " <FILE_NAME> <NUM_THREADS>" << std::endl;
+    std::cout << "Usage: " << argv[0] << " <FILE_NAME> <NUM_THREADS> [--parallel-read]\n"
+              << "With --parallel-read, every thread parses its own part of the file into memory before the primes are\n"
+              << "counted, instead of streaming the file through the threads in chunks." << std::endl;
     std::exit(1);
   }
 
+  if (argc == 4)
+  {
+    stations::StationOptions options;
+    options.set_num_threads(std::stoi(argv[2]));
+    std::vector<int> const ints = stations::read_integers_in_parallel(argv[1], stations::StationOptions(options));
+    std::size_t const num_primes = stations::count_if(std::move(options), ints.begin(), ints.end(), is_prime);
+    std::cout << "Number of primes are " << num_primes << "." << std::endl;
+    return 0;
+  }
+
   // Read a file with positive integers. The format should be
   stations::ReadIntegersFromFile riff(argv[1]);
   std::size_t const num_threads = std::stoi(argv[2]);
@@ -66,14 +69,26 @@ int main (int argc, char** argv)
   std::cout << "Number of threads are " << num_threads << "." << std::endl;
   std::cout << "Each chunk has " << riff.get_chunk_size() << " integers." << std::endl;
 
-  {
-    std::vector<std::shared_ptr<std::vector<int> > > all_primes;
-    stations::Station keep_primes_station;
-
-    for (auto ints = riff(); ints->size() > 0; ints = riff())
-    {
-      keep_primes_station.add_work(keep_primes, ints);
-      all_primes.push_back(ints);
-    }
-  }
+  // Stream the chunks through the workers, which keep the primes only. The file is read, filtered and counted at the
+  // same time, and only a few chunks are in memory however large the file is. The chunks are reused, so nothing is
+  // allocated once the stream is running.
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  stations::ChunkPool<int> pool(num_threads * options.max_queue_size + 1, riff.get_chunk_size());
+  std::size_t num_primes = 0;
+
+  stations::run_pipeline<stations::PooledChunk<int> >(
+    std::move(options),
+    [&riff, &pool](stations::PooledChunk<int> & ints){
+      ints = pool.acquire();
+      return riff(*ints);
+    } /*source*/,
+    [](stations::PooledChunk<int> && ints){
+      ints->erase(std::remove_if(ints->begin(), ints->end(), [](int const x){return !is_prime(x);}), ints->end());
+      return std::move(ints);
+    } /*stage*/,
+    [&num_primes](stations::PooledChunk<int> && primes){num_primes += primes->size();} /*sink*/
+    );
+
+  std::cout << "Number of primes are " << num_primes << "." << std::endl;
 }
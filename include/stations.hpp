@@ -1,7 +1,19 @@
 #pragma once
 
 #include <stations/algorithm.hpp>
+#include <stations/arena.hpp>
+#include <stations/cancellation_token.hpp>
+#include <stations/chunk_pool.hpp>
+#include <stations/future.hpp>
 #include <stations/join.hpp>
+#include <stations/numeric.hpp>
+#include <stations/pipeline.hpp>
+#include <stations/radix_sort.hpp>
 #include <stations/split.hpp>
 #include <stations/station.hpp>
+#include <stations/station_stats.hpp>
+#include <stations/task.hpp>
+#include <stations/task_graph.hpp>
+#include <stations/thread_pool.hpp>
+#include <stations/tracer.hpp>
 #include <stations/worker_queue.hpp>
@@ -1,48 +1,239 @@
 #pragma once
 
+#include <algorithm> // std::fill, std::sort
 #include <chrono>
-#include <iterator> // std::iterator_traits
+#include <cstddef> // std::size_t
+#include <functional> // std::less, std::plus
+#include <iterator> // std::advance, std::distance, std::iterator_traits, std::next
+#include <memory> // std::addressof, std::unique_ptr
+#include <new> // placement new
 #include <thread> // std::thread::hardware_concurrency
+#include <utility> // std::move, std::pair
 
-#include <stations/internal/algorithm_help_functions.hpp>
+#include <stations/internal/algorithm_help_functions.hpp> // stations_internal::get_grain_size
+#include <stations/internal/padded_value.hpp> // stations_internal::PaddedValue
+#include <stations/internal/parallel_merge.hpp> // stations_internal::add_merges_of_neighbouring_runs, merge_runs_in_windows
+#include <stations/internal/uninitialized_buffer.hpp> // stations_internal::UninitializedBuffer
 
-#include <stations/partition_iterator.hpp>
+#include <stations/cancellation_token.hpp> // stations::CancellationToken
+#include <stations/numeric.hpp> // stations::transform_reduce
+#include <stations/partition_iterator.hpp> // stations::get_partition_iterators, stations::get_partition_view
+#include <stations/radix_sort.hpp> // stations::radix_sort
 #include <stations/split.hpp>
 #include <stations/station.hpp>
 #include <stations/station_options.hpp> // stations::StationOptions
+#include <stations/task_graph.hpp> // stations::TaskGraph
+#include <stations/thread_pool.hpp> // stations::PooledStation
+#include <stations/tracer.hpp> // stations::named
 #include <stations/worker_queue.hpp>
 
 
+namespace stations_internal
+{
+
+/** Copies an element to its output. */
+struct CopyElement
+{
+  template <typename TOutput, typename TInput>
+  void
+  operator()(TOutput && output, TInput & input) const
+  {
+    output = input;
+  }
+};
+
+
+/** Moves an element to its output. */
+struct MoveElement
+{
+  template <typename TOutput, typename TInput>
+  void
+  operator()(TOutput && output, TInput & input) const
+  {
+    output = std::move(input);
+  }
+};
+
+
+/** Moves an element into memory where no element has been constructed, e.g. an UninitializedBuffer. */
+struct ConstructElement
+{
+  template <typename TOutput, typename TInput>
+  void
+  operator()(TOutput & output, TInput & input) const
+  {
+    ::new (static_cast<void *>(std::addressof(output))) TOutput(std::move(input));
+  }
+};
+
+
+/** Returns the default options of stations::sort. Small ranges are sorted with fewer threads, since their partitions
+ *  would be too small to pay for the jobs.
+ */
+stations::StationOptions inline
+get_sort_options(std::size_t const container_size)
+{
+  stations::StationOptions options;
+
+  if (options.num_threads > 2 && container_size >= 1000 && container_size <= 10000)
+  {
+    options.set_num_threads(2);
+  }
+  else if (options.num_threads > 4 && container_size >= 10000 && container_size <= 100000)
+  {
+    options.set_num_threads(4);
+  }
+
+  return options;
+}
+
+
+/**
+ * Transfers the elements for which p is true to d_true, and if write_false is set the other elements to the output
+ * get_d_false returns, in their original order. First each partition evaluates p on its elements, remembering the
+ * results, and counts the elements for which it is true. A prefix sum of the counts gives the output offsets of each
+ * partition, so every partition then writes its elements straight to their final positions. get_d_false is called
+ * with the number of elements for which p is true, so the other elements can be placed after them. Returns the number
+ * of elements for which p is true.
+ */
+template <typename InputIt, typename OutputTrueIt, typename TGetFalseOutput, typename UnaryPredicate,
+          typename TTransfer>
+std::size_t inline
+stable_partition_copy(stations::StationOptions && options,
+                      InputIt first,
+                      InputIt last,
+                      OutputTrueIt d_true,
+                      TGetFalseOutput get_d_false,
+                      bool const write_false,
+                      UnaryPredicate p,
+                      TTransfer transfer)
+{
+  using OutputFalseIt = decltype(get_d_false(std::size_t()));
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  std::size_t const num_partitions = partitions.num_partitions();
+  std::vector<std::size_t> partition_offsets(num_partitions + 1, 0);
+
+  for (std::size_t i = 0; i < num_partitions; ++i)
+  {
+    partition_offsets[i + 1] = partition_offsets[i] +
+                               std::distance(partitions.partition_first(i), partitions.partition_last(i));
+  }
+
+  // The predicate of each element, so it is only evaluated once
+  std::unique_ptr<bool[]> is_true(new bool[partition_offsets.back()]);
+  std::vector<PaddedValue<std::size_t> > true_counts(num_partitions, PaddedValue<std::size_t>(0));
+  stations::PooledStation partition_copy_station(options);
+
+  for (std::size_t i = 0; i < num_partitions; ++i)
+  {
+    partition_copy_station.add_work([p](InputIt first, InputIt last, bool * is_true, PaddedValue<std::size_t> * count)
+      {
+        std::size_t num_true = 0;
+
+        for (; first != last; ++first, ++is_true)
+        {
+          *is_true = p(*first);
+          num_true += *is_true;
+        }
+
+        count->value = num_true;
+      } /*function*/,
+                                    partitions.partition_first(i), /*first*/
+                                    partitions.partition_last(i), /*last*/
+                                    is_true.get() + partition_offsets[i],
+                                    &true_counts[i]
+                                    );
+  }
+
+  partition_copy_station.wait();
+  std::size_t num_true = 0;
+
+  for (auto const & true_count : true_counts)
+    num_true += true_count.value;
+
+  OutputFalseIt const d_false = get_d_false(num_true);
+  std::size_t true_offset = 0;
+
+  for (std::size_t i = 0; i < num_partitions; ++i)
+  {
+    std::size_t const partition_true_offset = true_offset;
+    true_offset += true_counts[i].value;
+
+    if (partition_offsets[i] == partition_offsets[i + 1])
+      continue;
+
+    // Elements for which p is false are written after the ones in earlier partitions
+    OutputFalseIt d_partition_false =
+      write_false ? std::next(d_false, partition_offsets[i] - partition_true_offset) : d_false;
+
+    partition_copy_station.add_work([write_false, transfer](InputIt first, InputIt last, bool const * is_true,
+                                                            OutputTrueIt d_true, OutputFalseIt d_false)
+      {
+        for (; first != last; ++first, ++is_true)
+        {
+          if (*is_true)
+          {
+            transfer(*d_true, *first);
+            ++d_true;
+          }
+          else if (write_false)
+          {
+            transfer(*d_false, *first);
+            ++d_false;
+          }
+        }
+      } /*function*/,
+                                    partitions.partition_first(i), /*first*/
+                                    partitions.partition_last(i), /*last*/
+                                    is_true.get() + partition_offsets[i],
+                                    std::next(d_true, partition_true_offset),
+                                    d_partition_false
+                                    );
+  }
+
+  partition_copy_station.join();
+  return num_true;
+}
+
+
+} // namespace stations_internal
+
+
 namespace stations
 {
 
+/** Returns true if f is true for all elements. Once an element is found for which f is false, the other jobs stop
+ *  within a few polls of the cancellation token.
+ */
 template <typename InputIt, typename UnaryPredicate>
 bool inline
 all_of(StationOptions && options, InputIt first, InputIt last, UnaryPredicate f)
 {
-  std::atomic<bool> false_found{false}; // Needs to be atomic for thread safety
-  stations::Station all_of_station(options);
-  std::vector<InputIt> partition_iterators =
-    stations::get_partition_iterators(first, last, options);
+  using TReference = typename std::iterator_traits<InputIt>::reference;
+  stations::CancellationToken false_found;
+  stations::PooledStation all_of_station(options);
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
 
-  for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
   {
     // If some expression have found to be false we can safely skip the rest of the work
-    if (false_found)
+    if (false_found.is_cancelled())
       break;
 
     all_of_station.add_work([&false_found, f](InputIt first, InputIt last)
       {
-        if (!std::all_of(first, last, f))
-          false_found = true;
+        auto is_false = [&f](TReference value){return !f(value);};
+
+        if (stations_internal::find_if_until_cancelled(first, last, is_false, false_found) != last)
+          false_found.cancel();
       },                       /*function*/
-                            partition_iterators[i], /*first*/
-                            partition_iterators[i + 1] /*last*/
+                            partitions.partition_first(i), /*first*/
+                            partitions.partition_last(i) /*last*/
                             );
   }
 
   all_of_station.join();
-  return !false_found;
+  return !false_found.is_cancelled();
 }
 
 
@@ -51,37 +242,39 @@ bool inline
 all_of(InputIt first, InputIt last, UnaryPredicate f)
 {
   StationOptions options;
-  options.chunk_size = 1;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
   return all_of(std::move(options), first, last, f);
 }
 
 
+/** Returns true if f is true for any element. Once such an element is found, the other jobs stop within a few polls
+ *  of the cancellation token.
+ */
 template <typename InputIt, typename UnaryPredicate>
 bool inline
 any_of(StationOptions && options, InputIt first, InputIt last, UnaryPredicate f)
 {
-  std::atomic<bool> true_found{false}; // Needs to be atomic for thread safety
-  std::vector<InputIt> partition_iterators =
-    stations::get_partition_iterators(first, last, options);
-  stations::Station any_of_station(options);
+  stations::CancellationToken true_found;
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  stations::PooledStation any_of_station(options);
 
-  for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
   {
-    if (true_found)
+    if (true_found.is_cancelled())
       break;
 
     any_of_station.add_work([&true_found, f](InputIt first, InputIt last)
       {
-        if (std::any_of(first, last, f))
-          true_found = true;
+        if (stations_internal::find_if_until_cancelled(first, last, f, true_found) != last)
+          true_found.cancel();
       } /*function*/,
-                            partition_iterators[i], /*first*/
-                            partition_iterators[i + 1] /*last*/
+                            partitions.partition_first(i), /*first*/
+                            partitions.partition_last(i) /*last*/
                             );
   }
 
   any_of_station.join();
-  return true_found;
+  return true_found.is_cancelled();
 }
 
 
@@ -90,41 +283,43 @@ bool inline
 any_of(InputIt first, InputIt last, UnaryPredicate f)
 {
   StationOptions options;
-  options.chunk_size = 1;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
   return any_of(std::move(options), first, last, f);
 }
 
 
-template <typename InputIt, typename T>
-T inline
-count(StationOptions && options, InputIt first, InputIt last, T const & value)
+/** Copies the elements for which p is true to d_first, keeping their order. Returns the end of the output. */
+template <typename InputIt, typename OutputIt, typename UnaryPredicate>
+OutputIt inline
+copy_if(StationOptions && options, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p)
 {
-  std::vector<InputIt> partition_iterators =
-    stations::get_partition_iterators(first, last, options);
-  std::vector<std::shared_ptr<T> > counts;
-  stations::Station count_station(options);
+  std::size_t const num_copied = stations_internal::stable_partition_copy(
+    std::move(options), first, last, d_first, [d_first](std::size_t){return d_first;}, false /*write_false*/, p,
+    stations_internal::CopyElement());
+
+  return std::next(d_first, num_copied);
+}
 
-  for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
-  {
-    counts.push_back(std::make_shared<T>(0));
-    count_station.add_work([value](InputIt first, InputIt last, std::shared_ptr<T> ret)
-      {
-        *ret = std::count(first, last, value);
-      } /*function*/,
-                           partition_iterators[i], /*first*/
-                           partition_iterators[i + 1], /*last*/
-                           counts.back()
-                           );
-  }
 
-  // Merge region
-  T sum = 0;
-  count_station.join(); // Join all threads
+template <typename InputIt, typename OutputIt, typename UnaryPredicate>
+OutputIt inline
+copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::copy_if(std::move(options), first, last, d_first, p);
+}
 
-  for (auto const & count : counts)
-    sum += *count;
 
-  return sum;
+template <typename InputIt, typename T>
+T inline
+count(StationOptions && options, InputIt first, InputIt last, T const & value)
+{
+  using TValue = typename std::iterator_traits<InputIt>::value_type;
+
+  // The elements are compared with the value as it is, like std::count does
+  return stations::transform_reduce(std::move(options), first, last, T(0), std::plus<T>(),
+                                    [value](TValue const & element) -> T {return element == value ? 1 : 0;});
 }
 
 
@@ -143,36 +338,10 @@ typename std::iterator_traits<InputIt>::difference_type inline
 count_if(StationOptions && options, InputIt first, InputIt last, UnaryPredicate p)
 {
   using T = typename std::iterator_traits<InputIt>::difference_type;
-  std::vector<InputIt> partition_iterators =
-    stations::get_partition_iterators(first, last, options);
-  std::vector<std::shared_ptr<T> > counts;
-  stations::Station count_if_station(options);
+  using TValue = typename std::iterator_traits<InputIt>::value_type;
 
-  for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
-  {
-    counts.push_back(std::make_shared<T>(0));
-    count_if_station.add_work([p](InputIt first, InputIt last, std::shared_ptr<T> ret)
-      {
-#ifdef D_GLIBCXX_PARALLEL
-        *ret = std::count_if(first, last, p, __gnu_parallel::sequential_tag());
-#else
-        *ret = std::count_if(first, last, p);
-#endif
-      } /*function*/,
-                              partition_iterators[i], /*first*/
-                              partition_iterators[i + 1], /*last*/
-                              counts.back()
-                              );
-  }
-
-  // Merge region
-  T sum = 0;
-  count_if_station.join();
-
-  for (auto const & count : counts)
-    sum += *count;
-
-  return sum;
+  return stations::transform_reduce(std::move(options), first, last, T(0), std::plus<T>(),
+                                    [p](TValue const & element) -> T {return p(element) ? 1 : 0;});
 }
 
 
@@ -188,19 +357,17 @@ template <typename InputIt, typename T>
 void inline
 fill(StationOptions && options, InputIt first, InputIt last, T const & value)
 {
-  std::vector<InputIt> partition_iterators =
-    stations::get_partition_iterators(first, last, options);
-  std::vector<std::shared_ptr<T> > counts;
-  stations::Station fill_station(options);
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  stations::PooledStation fill_station(options);
 
-  for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
   {
     fill_station.add_work([value](InputIt first, InputIt last)
       {
         std::fill(first, last, value);
       } /*function*/,
-                          partition_iterators[i], /*first*/
-                          partition_iterators[i + 1] /*last*/
+                          partitions.partition_first(i), /*first*/
+                          partitions.partition_last(i) /*last*/
                           );
   }
 
@@ -218,18 +385,186 @@ fill(InputIt first, InputIt last, T const & value)
 }
 
 
+/**
+ * Fills the range with one even partition for each thread, where thread i of the station writes partition i. On Linux
+ * a page of memory is placed on the NUMA node of the thread which writes to it first, so if the memory has not been
+ * written yet, e.g. it was allocated with `new T[n]` for a T without a constructor, each partition ends up on the node
+ * of its thread. Jobs which process the partitions with add_to_thread on a PooledStation with the same options then
+ * read local memory, since the thread pool gives it the same station. Pin the workers with the affinity options, so
+ * they do not move to another node afterwards.
+ */
+template <typename RandomIt, typename T>
+void inline
+first_touch_fill(StationOptions && options, RandomIt first, RandomIt last, T const & value)
+{
+  std::size_t const container_size = std::distance(first, last);
+  std::size_t const num_threads = options.num_threads;
+  stations::PooledStation fill_station(options);
+
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    fill_station.get_station().add_to_thread(i, [value](RandomIt first, RandomIt last)
+      {
+        std::fill(first, last, value);
+      } /*function*/,
+                                             first + container_size * i / num_threads, /*first*/
+                                             first + container_size * (i + 1) / num_threads /*last*/
+                                             );
+  }
+
+  fill_station.join();
+}
+
+
+/** Returns the first element for which p is true, or last if there is none. When a partition finds a match, the
+ *  partitions after it are cancelled, but the ones before it keep looking for an earlier match.
+ */
+template <typename InputIt, typename UnaryPredicate>
+InputIt inline
+find_if(StationOptions && options, InputIt first, InputIt last, UnaryPredicate p)
+{
+  stations::CancellationToken match_found;
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  std::vector<InputIt> matches(partitions.num_partitions(), last);
+  stations::PooledStation find_if_station(options);
+
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
+  {
+    // Partitions are added in order, so all remaining partitions come after a match
+    if (match_found.is_cancelled(i))
+      break;
+
+    find_if_station.add_work([&match_found, p](InputIt first, InputIt last, std::size_t const i, InputIt * match)
+      {
+        InputIt const it = stations_internal::find_if_until_cancelled(first, last, p, match_found, i);
+
+        if (it != last)
+        {
+          *match = it;
+          match_found.cancel_from(i + 1);
+        }
+      } /*function*/,
+                             partitions.partition_first(i), /*first*/
+                             partitions.partition_last(i), /*last*/
+                             i,
+                             &matches[i]
+                             );
+  }
+
+  find_if_station.join();
+
+  for (auto const & match : matches)
+  {
+    if (match != last)
+      return match;
+  }
+
+  return last;
+}
+
+
+template <typename InputIt, typename UnaryPredicate>
+InputIt inline
+find_if(InputIt first, InputIt last, UnaryPredicate p)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::find_if(std::move(options), first, last, p);
+}
+
+
+/** Returns the first element which is equal to value, or last if there is none. */
+template <typename InputIt, typename T>
+InputIt inline
+find(StationOptions && options, InputIt first, InputIt last, T const & value)
+{
+  using TReference = typename std::iterator_traits<InputIt>::reference;
+  return stations::find_if(std::move(options), first, last, [value](TReference element){return element == value;});
+}
+
+
+template <typename InputIt, typename T>
+InputIt inline
+find(InputIt first, InputIt last, T const & value)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::find(std::move(options), first, last, value);
+}
+
+
+/** Returns the first element which is equal to any of the elements in [s_first, s_last), using p to compare them. */
+template <typename InputIt, typename ForwardIt, typename BinaryPredicate>
+InputIt inline
+find_first_of(StationOptions && options, InputIt first, InputIt last, ForwardIt s_first, ForwardIt s_last,
+              BinaryPredicate p)
+{
+  using TReference = typename std::iterator_traits<InputIt>::reference;
+
+  return stations::find_if(std::move(options), first, last, [s_first, s_last, p](TReference value)
+    {
+      for (ForwardIt it = s_first; it != s_last; ++it)
+      {
+        if (p(value, *it))
+          return true;
+      }
+
+      return false;
+    });
+}
+
+
+template <typename InputIt, typename ForwardIt>
+InputIt inline
+find_first_of(StationOptions && options, InputIt first, InputIt last, ForwardIt s_first, ForwardIt s_last)
+{
+  using TValue = typename std::iterator_traits<InputIt>::value_type;
+  using TSearchValue = typename std::iterator_traits<ForwardIt>::value_type;
+
+  return stations::find_first_of(std::move(options), first, last, s_first, s_last,
+                                 [](TValue const & a, TSearchValue const & b){return a == b;});
+}
+
+
+template <typename InputIt, typename ForwardIt, typename BinaryPredicate>
+InputIt inline
+find_first_of(InputIt first, InputIt last, ForwardIt s_first, ForwardIt s_last, BinaryPredicate p)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::find_first_of(std::move(options), first, last, s_first, s_last, p);
+}
+
+
+template <typename InputIt, typename ForwardIt>
+InputIt inline
+find_first_of(InputIt first, InputIt last, ForwardIt s_first, ForwardIt s_last)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::find_first_of(std::move(options), first, last, s_first, s_last);
+}
+
+
+/** Calls f on every element. Each job calls f on all elements of one partition, so f gets copied once per partition. */
 template <typename InputIt, typename UnaryFunction>
 UnaryFunction inline
 for_each(StationOptions && options, InputIt first, InputIt last, UnaryFunction f)
 {
-  std::vector<InputIt> partition_iterators =
-    stations::get_partition_iterators(first, last, options);
-  stations::Station for_each_station(options);
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  stations::PooledStation for_each_station(options);
 
-  for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
-    for_each_station.add_work([f](InputIt it){
-        f(*it);
-      } /*function*/, partition_iterators[i] /*it*/);
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
+  {
+    for_each_station.add_work([f](InputIt first, InputIt last) mutable
+      {
+        for (; first != last; ++first)
+          f(*first);
+      } /*function*/,
+                              partitions.partition_first(i), /*first*/
+                              partitions.partition_last(i) /*last*/
+                              );
+  }
 
   for_each_station.join();
   return f;
@@ -241,8 +576,205 @@ UnaryFunction inline
 for_each(InputIt first, InputIt last, UnaryFunction f)
 {
   StationOptions options;
-  options.chunk_size = 1;
-  return for_each(std::move(options), first, last, f);
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::for_each(std::move(options), first, last, f);
+}
+
+
+/** Calls f on the first n elements and returns the iterator past the last of them. */
+template <typename InputIt, typename Size, typename UnaryFunction>
+InputIt inline
+for_each_n(StationOptions && options, InputIt first, Size n, UnaryFunction f)
+{
+  InputIt last = std::next(first, n);
+  stations::for_each(std::move(options), first, last, f);
+  return last;
+}
+
+
+template <typename InputIt, typename Size, typename UnaryFunction>
+InputIt inline
+for_each_n(InputIt first, Size n, UnaryFunction f)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(n, options.num_threads);
+  return stations::for_each_n(std::move(options), first, n, f);
+}
+
+
+/** Returns the first smallest element, or last if the range is empty. Each partition finds its own smallest element
+ *  into a padded partial result, and the partial results are compared in the order of the partitions.
+ */
+template <typename ForwardIt, typename Compare>
+ForwardIt inline
+min_element(StationOptions && options, ForwardIt first, ForwardIt last, Compare comp)
+{
+  stations::PartitionView<ForwardIt> partitions = stations::get_partition_view(first, last, options);
+  std::vector<stations_internal::PaddedValue<ForwardIt> > partials(partitions.num_partitions(),
+                                                                  stations_internal::PaddedValue<ForwardIt>(last));
+  stations::PooledStation min_element_station(options);
+
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
+  {
+    if (partitions.partition_first(i) == partitions.partition_last(i))
+      continue;
+
+    min_element_station.add_work([comp](ForwardIt first, ForwardIt last,
+                                        stations_internal::PaddedValue<ForwardIt> * partial)
+      {
+        ForwardIt smallest = first;
+
+        for (++first; first != last; ++first)
+        {
+          if (comp(*first, *smallest))
+            smallest = first;
+        }
+
+        partial->value = smallest;
+        partial->has_value = true;
+      } /*function*/,
+                                 partitions.partition_first(i), /*first*/
+                                 partitions.partition_last(i), /*last*/
+                                 &partials[i]
+                                 );
+  }
+
+  min_element_station.join();
+  ForwardIt smallest = last;
+
+  for (auto const & partial : partials)
+  {
+    if (partial.has_value && (smallest == last || comp(*partial.value, *smallest)))
+      smallest = partial.value;
+  }
+
+  return smallest;
+}
+
+
+template <typename ForwardIt, typename Compare>
+ForwardIt inline
+min_element(ForwardIt first, ForwardIt last, Compare comp)
+{
+  return stations::min_element(StationOptions(), first, last, comp);
+}
+
+
+template <typename ForwardIt>
+ForwardIt inline
+min_element(ForwardIt first, ForwardIt last)
+{
+  using T = typename std::iterator_traits<ForwardIt>::value_type;
+  return stations::min_element(StationOptions(), first, last, std::less<T>());
+}
+
+
+/** Returns the first smallest and the last largest element, like std::minmax_element, in a single pass over the
+ *  range. Both are last if the range is empty.
+ */
+template <typename ForwardIt, typename Compare>
+std::pair<ForwardIt, ForwardIt> inline
+minmax_element(StationOptions && options, ForwardIt first, ForwardIt last, Compare comp)
+{
+  using TMinMax = std::pair<ForwardIt, ForwardIt>;
+  stations::PartitionView<ForwardIt> partitions = stations::get_partition_view(first, last, options);
+  std::vector<stations_internal::PaddedValue<TMinMax> > partials(partitions.num_partitions(),
+                                                                stations_internal::PaddedValue<TMinMax>(
+                                                                  TMinMax(last, last)));
+  stations::PooledStation minmax_element_station(options);
+
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
+  {
+    if (partitions.partition_first(i) == partitions.partition_last(i))
+      continue;
+
+    minmax_element_station.add_work([comp](ForwardIt first, ForwardIt last,
+                                           stations_internal::PaddedValue<TMinMax> * partial)
+      {
+        ForwardIt smallest = first;
+        ForwardIt largest = first;
+
+        for (++first; first != last; ++first)
+        {
+          if (comp(*first, *smallest))
+            smallest = first;
+
+          if (!comp(*first, *largest))
+            largest = first;
+        }
+
+        partial->value = TMinMax(smallest, largest);
+        partial->has_value = true;
+      } /*function*/,
+                                    partitions.partition_first(i), /*first*/
+                                    partitions.partition_last(i), /*last*/
+                                    &partials[i]
+                                    );
+  }
+
+  minmax_element_station.join();
+  TMinMax minmax(last, last);
+
+  for (auto const & partial : partials)
+  {
+    if (!partial.has_value)
+      continue;
+
+    if (minmax.first == last || comp(*partial.value.first, *minmax.first))
+      minmax.first = partial.value.first;
+
+    if (minmax.second == last || !comp(*partial.value.second, *minmax.second))
+      minmax.second = partial.value.second;
+  }
+
+  return minmax;
+}
+
+
+template <typename ForwardIt, typename Compare>
+std::pair<ForwardIt, ForwardIt> inline
+minmax_element(ForwardIt first, ForwardIt last, Compare comp)
+{
+  return stations::minmax_element(StationOptions(), first, last, comp);
+}
+
+
+template <typename ForwardIt>
+std::pair<ForwardIt, ForwardIt> inline
+minmax_element(ForwardIt first, ForwardIt last)
+{
+  using T = typename std::iterator_traits<ForwardIt>::value_type;
+  return stations::minmax_element(StationOptions(), first, last, std::less<T>());
+}
+
+
+/** Returns the first largest element, or last if the range is empty. */
+template <typename ForwardIt, typename Compare>
+ForwardIt inline
+max_element(StationOptions && options, ForwardIt first, ForwardIt last, Compare comp)
+{
+  using TValue = typename std::iterator_traits<ForwardIt>::value_type;
+
+  // The first smallest element when the order is reversed is the first largest element
+  return stations::min_element(std::move(options), first, last,
+                               [comp](TValue const & a, TValue const & b){return comp(b, a);});
+}
+
+
+template <typename ForwardIt, typename Compare>
+ForwardIt inline
+max_element(ForwardIt first, ForwardIt last, Compare comp)
+{
+  return stations::max_element(StationOptions(), first, last, comp);
+}
+
+
+template <typename ForwardIt>
+ForwardIt inline
+max_element(ForwardIt first, ForwardIt last)
+{
+  using T = typename std::iterator_traits<ForwardIt>::value_type;
+  return stations::max_element(StationOptions(), first, last, std::less<T>());
 }
 
 
@@ -250,7 +782,7 @@ template <typename InputIt, typename UnaryPredicate>
 bool inline
 none_of(StationOptions && options, InputIt first, InputIt last, UnaryPredicate f)
 {
-  return !stations::any_of(options, first, last, f);
+  return !stations::any_of(std::move(options), first, last, f);
 }
 
 
@@ -262,54 +794,317 @@ none_of(InputIt first, InputIt last, UnaryPredicate f)
 }
 
 
-template <typename InputIt>
-void inline
-sort(StationOptions && options, InputIt first, InputIt last)
+/** Writes op applied to each element to d_first. Returns the end of the output. */
+template <typename InputIt, typename OutputIt, typename UnaryOperation>
+OutputIt inline
+transform(StationOptions && options, InputIt first, InputIt last, OutputIt d_first, UnaryOperation op)
 {
-  std::vector<InputIt> partition_iterators =
-    stations::get_partition_iterators(first, last, options);
-
-  stations::Station sort_station(options);
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  stations::PooledStation transform_station(options);
+  OutputIt d_partition_first = d_first;
 
-  for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
   {
-    sort_station.add_work([](InputIt first, InputIt last){
-        std::sort(first, last);
+    transform_station.add_work([op](InputIt first, InputIt last, OutputIt d_first)
+      {
+        for (; first != last; ++first, ++d_first)
+          *d_first = op(*first);
       } /*function*/,
-                          partition_iterators[i], /*first*/
-                          partition_iterators[i + 1] /*last*/
-                          );
+                               partitions.partition_first(i), /*first*/
+                               partitions.partition_last(i), /*last*/
+                               d_partition_first
+                               );
+
+    std::advance(d_partition_first, std::distance(partitions.partition_first(i), partitions.partition_last(i)));
   }
 
-  // After this join, all partitions are sorted, then we need to merge the sorted partition
-  sort_station.join();
+  transform_station.join();
+  return d_partition_first;
+}
+
+
+template <typename InputIt, typename OutputIt, typename UnaryOperation>
+OutputIt inline
+transform(InputIt first, InputIt last, OutputIt d_first, UnaryOperation op)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::transform(std::move(options), first, last, d_first, op);
+}
+
+
+/** Writes op applied to each pair of elements of the two ranges to d_first. Returns the end of the output. */
+template <typename InputIt1, typename InputIt2, typename OutputIt, typename BinaryOperation>
+OutputIt inline
+transform(StationOptions && options, InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt d_first,
+          BinaryOperation op)
+{
+  stations::PartitionView<InputIt1> partitions = stations::get_partition_view(first1, last1, options);
+  stations::PooledStation transform_station(options);
+  InputIt2 partition_first2 = first2;
+  OutputIt d_partition_first = d_first;
 
-  // I have tried to implement a multi-threaded merge, but actually the single threaded version
-  // was always faster! x(
-  for (std::size_t d = 2; d < partition_iterators.size(); ++d)
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
   {
-    std::inplace_merge(partition_iterators[0], partition_iterators[d - 1], partition_iterators[d]);
+    transform_station.add_work([op](InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt d_first)
+      {
+        for (; first1 != last1; ++first1, ++first2, ++d_first)
+          *d_first = op(*first1, *first2);
+      } /*function*/,
+                               partitions.partition_first(i), /*first1*/
+                               partitions.partition_last(i), /*last1*/
+                               partition_first2,
+                               d_partition_first
+                               );
+
+    auto const partition_size = std::distance(partitions.partition_first(i), partitions.partition_last(i));
+    std::advance(partition_first2, partition_size);
+    std::advance(d_partition_first, partition_size);
   }
+
+  transform_station.join();
+  return d_partition_first;
 }
 
 
-template <typename InputIt>
-void inline
-sort(InputIt first, InputIt last)
+template <typename InputIt1, typename InputIt2, typename OutputIt, typename BinaryOperation>
+OutputIt inline
+transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt d_first, BinaryOperation op)
 {
   StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first1, last1), options.num_threads);
+  return stations::transform(std::move(options), first1, last1, first2, d_first, op);
+}
+
+
+/** Copies the elements for which p is true to d_true and the others to d_false, keeping their order. Returns the ends
+ *  of both outputs.
+ */
+template <typename InputIt, typename OutputIt1, typename OutputIt2, typename UnaryPredicate>
+std::pair<OutputIt1, OutputIt2> inline
+partition_copy(StationOptions && options, InputIt first, InputIt last, OutputIt1 d_true, OutputIt2 d_false,
+               UnaryPredicate p)
+{
   std::size_t const container_size = std::distance(first, last);
+  std::size_t const num_true = stations_internal::stable_partition_copy(
+    std::move(options), first, last, d_true, [d_false](std::size_t){return d_false;}, true /*write_false*/, p,
+    stations_internal::CopyElement());
 
-  if (options.num_threads > 2 && container_size >= 1000 && container_size <= 10000)
+  return std::pair<OutputIt1, OutputIt2>(std::next(d_true, num_true), std::next(d_false, container_size - num_true));
+}
+
+
+template <typename InputIt, typename OutputIt1, typename OutputIt2, typename UnaryPredicate>
+std::pair<OutputIt1, OutputIt2> inline
+partition_copy(InputIt first, InputIt last, OutputIt1 d_true, OutputIt2 d_false, UnaryPredicate p)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::partition_copy(std::move(options), first, last, d_true, d_false, p);
+}
+
+
+/**
+ * Moves the elements for which p is true before the others, keeping the order within both groups (like
+ * std::stable_partition). Returns the first element of the second group. The elements are moved to their final
+ * positions in a buffer as large as the range, and then moved back in parallel.
+ */
+template <typename ForwardIt, typename UnaryPredicate>
+ForwardIt inline
+partition(StationOptions && options, ForwardIt first, ForwardIt last, UnaryPredicate p)
+{
+  using T = typename std::iterator_traits<ForwardIt>::value_type;
+  std::size_t const container_size = std::distance(first, last);
+  stations_internal::UninitializedBuffer<T> buffer(container_size);
+  T * const buffer_first = buffer.get();
+  StationOptions move_back_options(options);
+
+  // The elements for which p is false go right after the ones for which it is true
+  std::size_t const num_true = stations_internal::stable_partition_copy(
+    std::move(options), first, last, buffer_first, [buffer_first](std::size_t num_true){return buffer_first + num_true;},
+    true /*write_false*/, p, stations_internal::ConstructElement());
+  buffer.set_num_constructed(container_size);
+
+  stations::transform(std::move(move_back_options), buffer.get(), buffer.get() + container_size, first,
+                      [](T & value) -> T && {return std::move(value);});
+
+  return std::next(first, num_true);
+}
+
+
+template <typename ForwardIt, typename UnaryPredicate>
+ForwardIt inline
+partition(ForwardIt first, ForwardIt last, UnaryPredicate p)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::partition(std::move(options), first, last, p);
+}
+
+
+/**
+ * Removes the elements for which p is true, by moving the others to the front of the range in their original order.
+ * Returns the end of the remaining elements. Like partition, the remaining elements go through a buffer.
+ */
+template <typename ForwardIt, typename UnaryPredicate>
+ForwardIt inline
+remove_if(StationOptions && options, ForwardIt first, ForwardIt last, UnaryPredicate p)
+{
+  using T = typename std::iterator_traits<ForwardIt>::value_type;
+  using TReference = typename std::iterator_traits<ForwardIt>::reference;
+  stations_internal::UninitializedBuffer<T> buffer(std::distance(first, last));
+  T * const buffer_first = buffer.get();
+  StationOptions move_back_options(options);
+
+  std::size_t const num_kept = stations_internal::stable_partition_copy(
+    std::move(options), first, last, buffer_first, [buffer_first](std::size_t){return buffer_first;},
+    false /*write_false*/, [p](TReference value){return !p(value);}, stations_internal::ConstructElement());
+  buffer.set_num_constructed(num_kept);
+
+  return stations::transform(std::move(move_back_options), buffer.get(), buffer.get() + num_kept, first,
+                             [](T & value) -> T && {return std::move(value);});
+}
+
+
+template <typename ForwardIt, typename UnaryPredicate>
+ForwardIt inline
+remove_if(ForwardIt first, ForwardIt last, UnaryPredicate p)
+{
+  StationOptions options;
+  options.chunk_size = stations_internal::get_grain_size(std::distance(first, last), options.num_threads);
+  return stations::remove_if(std::move(options), first, last, p);
+}
+
+
+template <typename RandomIt, typename Compare>
+void inline
+sort(StationOptions && options, RandomIt first, RandomIt last, Compare comp)
+{
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  std::size_t const container_size = std::distance(first, last);
+  std::vector<RandomIt> partition_iterators =
+    stations::get_partition_iterators(first, last, options);
+
+  stations::PooledStation sort_station(options);
+
+  if (container_size <= options.max_merge_buffer_size)
   {
-    options.set_num_threads(2);
+    // Each merge starts as soon as its two runs are sorted, moving the elements back and forth between the range and a
+    // buffer, so partitions which sorted quickly do not wait for the slowest one
+    stations::TaskGraph graph;
+    std::vector<std::size_t> run_bounds;
+    std::vector<std::vector<std::size_t> > run_tasks;
+
+    for (std::size_t i = 0; i + 1 < partition_iterators.size(); ++i)
+    {
+      run_bounds.push_back(std::distance(first, partition_iterators[i]));
+      run_tasks.push_back(std::vector<std::size_t>(1, graph.add_task(stations::named("partition sort",
+        [comp](RandomIt first, RandomIt last){
+          std::sort(first, last, comp);
+        }) /*function*/,
+                                                                     partition_iterators[i], /*first*/
+                                                                     partition_iterators[i + 1] /*last*/
+                                                                     )));
+    }
+
+    run_bounds.push_back(container_size);
+    stations_internal::UninitializedBuffer<T> buffer(container_size);
+    bool is_in_buffer = false;
+    bool is_buffer_constructed = false;
+
+    while (run_bounds.size() > 2)
+    {
+      if (is_in_buffer)
+      {
+        stations_internal::add_merges_of_neighbouring_runs(graph, buffer.get(), first, run_bounds, run_tasks,
+                                                           options.num_threads, comp);
+      }
+      else if (is_buffer_constructed)
+      {
+        stations_internal::add_merges_of_neighbouring_runs(graph, first, buffer.get(), run_bounds, run_tasks,
+                                                           options.num_threads, comp);
+      }
+      else
+      {
+        // The first merges construct the elements of the buffer, later merges move into them
+        stations_internal::add_merges_of_neighbouring_runs(graph, first,
+                                                           stations_internal::ConstructingIterator<T>(buffer.get()),
+                                                           run_bounds, run_tasks, options.num_threads, comp);
+        is_buffer_constructed = true;
+      }
+
+      is_in_buffer = !is_in_buffer;
+    }
+
+    // A single run without a neighbour is moved as it is
+    if (is_in_buffer)
+    {
+      stations_internal::add_merges_of_neighbouring_runs(graph, buffer.get(), first, run_bounds, run_tasks,
+                                                         options.num_threads, comp);
+    }
+
+    graph.run(sort_station);
+
+    if (is_buffer_constructed)
+      buffer.set_num_constructed(container_size);
   }
-  else if (options.num_threads > 4 && container_size >= 10000 && container_size <= 100000)
+  else
   {
-    options.set_num_threads(4);
+    std::vector<std::size_t> run_bounds;
+
+    for (long i = 0; i < static_cast<long>(partition_iterators.size()) - 1; ++i)
+    {
+      run_bounds.push_back(std::distance(first, partition_iterators[i]));
+      sort_station.add_work(stations::named("partition sort", [comp](RandomIt first, RandomIt last){
+          std::sort(first, last, comp);
+        }) /*function*/,
+                            partition_iterators[i], /*first*/
+                            partition_iterators[i + 1] /*last*/
+                            );
+    }
+
+    run_bounds.push_back(container_size);
+
+    // After this wait, all partitions are sorted. The range is too large for a merge buffer, so the runs are merged in
+    // pieces, as many at a time as fit in a buffer of the largest size allowed.
+    sort_station.wait();
+    stations_internal::UninitializedBuffer<T> buffer(options.max_merge_buffer_size);
+    stations_internal::merge_runs_in_windows(sort_station, first, run_bounds, buffer.get(),
+                                             options.max_merge_buffer_size, options.num_threads, comp);
   }
 
-  stations::sort(std::move(options), first, last);
+  sort_station.join();
+}
+
+
+template <typename RandomIt>
+void inline
+sort(StationOptions && options, RandomIt first, RandomIt last)
+{
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+
+  // Numbers are faster to sort by their bytes than by comparing them
+  if (!stations_internal::try_radix_sort(std::move(options), first, last,
+                                         typename stations_internal::IsRadixSortable<RandomIt>::type()))
+  {
+    stations::sort(std::move(options), first, last, std::less<T>());
+  }
+}
+
+
+template <typename RandomIt, typename Compare>
+void inline
+sort(RandomIt first, RandomIt last, Compare comp)
+{
+  stations::sort(stations_internal::get_sort_options(std::distance(first, last)), first, last, comp);
+}
+
+
+template <typename RandomIt>
+void inline
+sort(RandomIt first, RandomIt last)
+{
+  stations::sort(stations_internal::get_sort_options(std::distance(first, last)), first, last);
 }
 
 
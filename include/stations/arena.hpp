@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm> // std::max
+#include <cstddef> // std::size_t, std::max_align_t
+#include <cstdint> // std::uintptr_t
+#include <memory> // std::unique_ptr
+#include <vector> // std::vector
+
+
+namespace stations
+{
+
+/**
+ * Memory which is handed out by bumping an offset into large blocks and is only freed all at once, by release(). The
+ * blocks are kept when the arena is released, so once an arena has grown to what one epoch of work needs, allocating
+ * from it never calls malloc again. Like std::pmr::monotonic_buffer_resource, deallocate() does nothing. An arena is
+ * not thread safe, each thread allocates from its own one, see get_thread_arena().
+ */
+class MonotonicArena
+{
+public:
+  /** Position in the arena, which an ArenaScope goes back to. */
+  struct Marker
+  {
+    std::size_t block;
+    std::size_t offset;
+  };
+
+  MonotonicArena(std::size_t const _min_block_size = 64 * 1024);
+
+  MonotonicArena(MonotonicArena const &) = delete;
+  MonotonicArena & operator=(MonotonicArena const &) = delete;
+
+  void * allocate(std::size_t const bytes, std::size_t const alignment = alignof(std::max_align_t));
+  void deallocate(void *, std::size_t, std::size_t = alignof(std::max_align_t));
+
+  /** Makes all memory of the arena free again, but keeps the blocks for later allocations. */
+  void release();
+
+  Marker get_marker() const;
+
+  /** Frees everything which was allocated after the marker was taken. */
+  void rewind(Marker const & marker);
+
+  /** Number of bytes in the blocks of the arena. */
+  std::size_t capacity() const;
+
+private:
+  struct Block
+  {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  std::vector<Block> blocks;
+  std::size_t current_block; /** Index of the block which is allocated from, equal to the number of blocks if none */
+  std::size_t offset; /** Number of bytes used in the current block */
+  std::size_t min_block_size;
+};
+
+
+/** Frees everything which was allocated from the arena during the lifetime of the scope, e.g. scratch memory of one
+ *  job. Scopes of the same arena must end in the reverse order of how they started.
+ */
+class ArenaScope
+{
+public:
+  explicit ArenaScope(MonotonicArena & _arena);
+  ~ArenaScope();
+
+  ArenaScope(ArenaScope const &) = delete;
+  ArenaScope & operator=(ArenaScope const &) = delete;
+
+private:
+  MonotonicArena & arena;
+  MonotonicArena::Marker marker;
+};
+
+
+/** An allocator for standard containers which allocates from an arena. The arena must outlive the container. */
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(MonotonicArena & _arena) : arena(&_arena) {}
+
+  template <typename U>
+  ArenaAllocator(ArenaAllocator<U> const & other) : arena(other.get_arena()) {}
+
+  T * allocate(std::size_t const n) {return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));}
+  void deallocate(T *, std::size_t) {}
+  MonotonicArena * get_arena() const {return arena;}
+
+private:
+  MonotonicArena * arena;
+};
+
+
+template <typename T, typename U>
+bool inline
+operator==(ArenaAllocator<T> const & a, ArenaAllocator<U> const & b)
+{
+  return a.get_arena() == b.get_arena();
+}
+
+
+template <typename T, typename U>
+bool inline
+operator!=(ArenaAllocator<T> const & a, ArenaAllocator<U> const & b)
+{
+  return a.get_arena() != b.get_arena();
+}
+
+
+/**
+ * Returns the arena of the calling thread. Jobs which run on a station get an arena which belongs to that station, so
+ * what they allocate from it stays valid until the station is joined or its reset_arenas() is called. Other threads
+ * get an arena of their own, which they release themselves.
+ */
+MonotonicArena & get_thread_arena();
+
+
+} // namespace stations
+
+
+namespace stations_internal
+{
+
+/** The arena of the station job which the thread is running, or nullptr if it is not running one. */
+inline
+stations::MonotonicArena * &
+get_current_arena()
+{
+  static thread_local stations::MonotonicArena * current_arena = nullptr;
+  return current_arena;
+}
+
+
+/** Makes the arena the one jobs get from get_thread_arena(), until the switch goes out of scope. */
+class ArenaSwitch
+{
+public:
+  explicit ArenaSwitch(stations::MonotonicArena & arena)
+    : previous_arena(get_current_arena())
+  {
+    get_current_arena() = &arena;
+  }
+
+  ~ArenaSwitch()
+  {
+    get_current_arena() = previous_arena;
+  }
+
+  ArenaSwitch(ArenaSwitch const &) = delete;
+  ArenaSwitch & operator=(ArenaSwitch const &) = delete;
+
+private:
+  stations::MonotonicArena * previous_arena;
+};
+
+
+} // namespace stations_internal
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+inline
+MonotonicArena::MonotonicArena(std::size_t const _min_block_size)
+  : current_block(0)
+  , offset(0)
+  , min_block_size(_min_block_size)
+{}
+
+
+inline
+void *
+MonotonicArena::allocate(std::size_t const bytes, std::size_t const alignment)
+{
+  while (current_block < blocks.size())
+  {
+    Block const & block = blocks[current_block];
+    std::uintptr_t const address = reinterpret_cast<std::uintptr_t>(block.data.get()) + offset;
+    std::size_t const padding = (alignment - address % alignment) % alignment;
+
+    if (offset + padding + bytes <= block.size)
+    {
+      offset += padding + bytes;
+      return block.data.get() + offset - bytes;
+    }
+
+    // Blocks which are kept from before a release can be too small for this allocation, then the next one is tried
+    ++current_block;
+    offset = 0;
+  }
+
+  // Each block is at least as large as all the blocks before it, so the number of blocks stays small
+  Block block;
+  block.size = std::max(std::max(min_block_size, capacity()), bytes + alignment);
+  block.data.reset(new char[block.size]);
+  blocks.push_back(std::move(block));
+  current_block = blocks.size() - 1;
+  return allocate(bytes, alignment);
+}
+
+
+void inline
+MonotonicArena::deallocate(void *, std::size_t, std::size_t)
+{}
+
+
+void inline
+MonotonicArena::release()
+{
+  current_block = 0;
+  offset = 0;
+}
+
+
+MonotonicArena::Marker inline
+MonotonicArena::get_marker() const
+{
+  Marker marker;
+  marker.block = current_block;
+  marker.offset = offset;
+  return marker;
+}
+
+
+void inline
+MonotonicArena::rewind(Marker const & marker)
+{
+  current_block = marker.block;
+  offset = marker.offset;
+}
+
+
+std::size_t inline
+MonotonicArena::capacity() const
+{
+  std::size_t bytes = 0;
+
+  for (auto const & block : blocks)
+    bytes += block.size;
+
+  return bytes;
+}
+
+
+inline
+ArenaScope::ArenaScope(MonotonicArena & _arena)
+  : arena(_arena)
+  , marker(_arena.get_marker())
+{}
+
+
+inline
+ArenaScope::~ArenaScope()
+{
+  arena.rewind(marker);
+}
+
+
+inline
+MonotonicArena &
+get_thread_arena()
+{
+  MonotonicArena * current_arena = stations_internal::get_current_arena();
+
+  if (current_arena)
+    return *current_arena;
+
+  static thread_local MonotonicArena thread_arena;
+  return thread_arena;
+}
+
+
+} // namespace stations
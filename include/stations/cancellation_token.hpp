@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+#include <limits> // std::numeric_limits
+
+
+namespace stations
+{
+
+/**
+ * Lets running jobs know that their work is no longer needed. Jobs poll the token every now and then and stop early
+ * when it is cancelled. Work has a position, e.g. the index of its partition, so work can be cancelled only after a
+ * position, which search algorithms use to keep looking for matches before the one they have found.
+ */
+class CancellationToken
+{
+public:
+  CancellationToken();
+
+  CancellationToken(CancellationToken const &) = delete;
+  CancellationToken & operator=(CancellationToken const &) = delete;
+
+  /** Cancels all work. */
+  void cancel();
+
+  /** Cancels the work at `position` and after it. Work before it is not affected. Safe to call from any thread. */
+  void cancel_from(std::size_t const position);
+
+  bool is_cancelled(std::size_t const position = 0) const;
+
+private:
+  std::atomic<std::size_t> first_cancelled; /** Lowest position which is cancelled */
+};
+
+
+} // namespace stations
+
+
+namespace stations_internal
+{
+
+/** Number of elements a job processes between polls of its cancellation token. */
+std::size_t constexpr CANCELLATION_POLL_INTERVAL = 1024;
+
+
+/** Returns the first element for which p returns true. Returns last if there is no such element, or if the work at
+ *  `position` was cancelled before it was found.
+ */
+template <typename InputIt, typename UnaryPredicate>
+InputIt inline
+find_if_until_cancelled(InputIt first,
+                        InputIt last,
+                        UnaryPredicate p,
+                        stations::CancellationToken const & token,
+                        std::size_t const position = 0)
+{
+  while (first != last)
+  {
+    if (token.is_cancelled(position))
+      return last;
+
+    for (std::size_t i = 0; i < CANCELLATION_POLL_INTERVAL && first != last; ++i, ++first)
+    {
+      if (p(*first))
+        return first;
+    }
+  }
+
+  return last;
+}
+
+
+} // namespace stations_internal
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+inline
+CancellationToken::CancellationToken()
+  : first_cancelled(std::numeric_limits<std::size_t>::max())
+{}
+
+
+void inline
+CancellationToken::cancel()
+{
+  first_cancelled.store(0, std::memory_order_relaxed);
+}
+
+
+void inline
+CancellationToken::cancel_from(std::size_t const position)
+{
+  std::size_t current = first_cancelled.load(std::memory_order_relaxed);
+
+  // Only ever lower the position, if another thread lowered it further then that is kept
+  while (position < current && !first_cancelled.compare_exchange_weak(current, position, std::memory_order_relaxed))
+  {}
+}
+
+
+bool inline
+CancellationToken::is_cancelled(std::size_t const position) const
+{
+  // Relaxed is enough, results are only read after the station has been joined
+  return position >= first_cancelled.load(std::memory_order_relaxed);
+}
+
+
+} // namespace stations
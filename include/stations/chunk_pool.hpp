@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <utility> // std::move
+#include <vector> // std::vector
+
+#include <stations/internal/ring_buffer.hpp> // stations_internal::RingBuffer
+
+
+namespace stations
+{
+
+template <typename T>
+class ChunkPool;
+
+
+/**
+ * A vector borrowed from a chunk pool. When the handle is destroyed the vector is cleared and given back to the pool,
+ * keeping its capacity, so the next chunk does not allocate. A default constructed handle holds a vector which does not
+ * belong to any pool. Handles are move-only and cheap to move, so they can be passed through a pipeline.
+ */
+template <typename T>
+class PooledChunk
+{
+public:
+  PooledChunk();
+  PooledChunk(PooledChunk && other);
+  PooledChunk & operator=(PooledChunk && other);
+  ~PooledChunk();
+
+  PooledChunk(PooledChunk const &) = delete;
+  PooledChunk & operator=(PooledChunk const &) = delete;
+
+  std::vector<T> & operator*();
+  std::vector<T> * operator->();
+
+  /** Gives the vector back to its pool now. Afterwards the handle holds an empty vector which belongs to no pool. */
+  void release();
+
+private:
+  friend class ChunkPool<T>;
+
+  ChunkPool<T> * pool;
+  std::vector<T> chunk;
+
+  PooledChunk(ChunkPool<T> & _pool, std::vector<T> && _chunk);
+};
+
+
+/**
+ * Vectors which are reserved up front and reused for chunks of a stream. acquire() hands out a free vector and the
+ * handle gives it back when it is dropped, so in the steady state of a stream nothing is allocated. If every vector is
+ * in use a new one is allocated, and if the pool is full when a vector comes back it is freed. Safe to use from any
+ * number of threads. The pool must outlive the handles it hands out.
+ */
+template <typename T>
+class ChunkPool
+{
+public:
+  ChunkPool(std::size_t const num_chunks, std::size_t const chunk_size);
+
+  ChunkPool(ChunkPool const &) = delete;
+  ChunkPool & operator=(ChunkPool const &) = delete;
+
+  /** Returns an empty vector with room for at least chunk_size elements. */
+  PooledChunk<T> acquire();
+
+  std::size_t get_chunk_size() const;
+
+private:
+  friend class PooledChunk<T>;
+
+  stations_internal::RingBuffer<std::vector<T> > free_chunks;
+  std::size_t chunk_size;
+
+  void give_back(std::vector<T> & chunk);
+};
+
+
+} // namespace stations
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+template <typename T>
+inline
+PooledChunk<T>::PooledChunk()
+  : pool(nullptr)
+{}
+
+
+template <typename T>
+inline
+PooledChunk<T>::PooledChunk(ChunkPool<T> & _pool, std::vector<T> && _chunk)
+  : pool(&_pool)
+  , chunk(std::move(_chunk))
+{}
+
+
+template <typename T>
+inline
+PooledChunk<T>::PooledChunk(PooledChunk && other)
+  : pool(other.pool)
+  , chunk(std::move(other.chunk))
+{
+  other.pool = nullptr;
+}
+
+
+template <typename T>
+inline
+PooledChunk<T> &
+PooledChunk<T>::operator=(PooledChunk && other)
+{
+  if (this != &other)
+  {
+    release();
+    pool = other.pool;
+    chunk = std::move(other.chunk);
+    other.pool = nullptr;
+  }
+
+  return *this;
+}
+
+
+template <typename T>
+inline
+PooledChunk<T>::~PooledChunk()
+{
+  release();
+}
+
+
+template <typename T>
+inline
+std::vector<T> &
+PooledChunk<T>::operator*()
+{
+  return chunk;
+}
+
+
+template <typename T>
+inline
+std::vector<T> *
+PooledChunk<T>::operator->()
+{
+  return &chunk;
+}
+
+
+template <typename T>
+void inline
+PooledChunk<T>::release()
+{
+  if (pool)
+  {
+    pool->give_back(chunk);
+    pool = nullptr;
+  }
+
+  chunk = std::vector<T>();
+}
+
+
+template <typename T>
+inline
+ChunkPool<T>::ChunkPool(std::size_t const num_chunks, std::size_t const _chunk_size)
+  : free_chunks(num_chunks)
+  , chunk_size(_chunk_size)
+{
+  for (std::size_t c = 0; c < num_chunks; ++c)
+  {
+    std::vector<T> chunk;
+    chunk.reserve(chunk_size);
+    free_chunks.try_push(chunk);
+  }
+}
+
+
+template <typename T>
+inline
+PooledChunk<T>
+ChunkPool<T>::acquire()
+{
+  std::vector<T> chunk;
+
+  if (!free_chunks.try_pop(chunk))
+    chunk.reserve(chunk_size);
+
+  return PooledChunk<T>(*this, std::move(chunk));
+}
+
+
+template <typename T>
+std::size_t inline
+ChunkPool<T>::get_chunk_size() const
+{
+  return chunk_size;
+}
+
+
+/** Keeps the vector for another chunk, unless the pool is full. */
+template <typename T>
+void inline
+ChunkPool<T>::give_back(std::vector<T> & chunk)
+{
+  chunk.clear();
+  free_chunks.try_push(chunk);
+}
+
+
+} // namespace stations
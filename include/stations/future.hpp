@@ -0,0 +1,209 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <new> // placement new
+#include <thread> // std::this_thread::yield
+#include <type_traits> // std::aligned_storage
+#include <utility> // std::forward, std::move
+
+#include <stations/internal/spin_wait.hpp> // stations_internal::cpu_relax
+
+
+namespace stations
+{
+
+/**
+ * Storage for the result of one job, which is allocated by the caller before the job is added, e.g. as an element of
+ * a vector with one slot per job. The job constructs the result in place and marks the slot ready, so no allocation
+ * or reference counting is needed per job. A slot can be reused after reset(), once its result has been consumed.
+ */
+template <typename T>
+class ResultSlot
+{
+public:
+  ResultSlot();
+  ~ResultSlot();
+
+  ResultSlot(ResultSlot const &) = delete;
+  ResultSlot & operator=(ResultSlot const &) = delete;
+
+  /** Constructs the result and marks the slot ready. Called by the job, exactly once. */
+  template <typename ... Args>
+  void set(Args && ... args);
+
+  bool is_ready() const;
+
+  /** Waits until the result is ready. Spins briefly and then yields, since results are expected soon. */
+  void wait() const;
+
+  /** Waits until the result is ready and returns it. */
+  T & get();
+
+  /** Destroys the result, so the slot can be used by another job. */
+  void reset();
+
+private:
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  std::atomic<bool> ready;
+};
+
+
+/**
+ * A handle to the result of a job added with Station::add_work_with_result. It is only a pointer to the slot the
+ * result is written to, so it is cheap to copy and the slot must outlive it.
+ */
+template <typename T>
+class Future
+{
+public:
+  explicit Future(ResultSlot<T> & _slot);
+
+  bool is_ready() const;
+  void wait() const;
+  T & get() const;
+
+private:
+  ResultSlot<T> * slot;
+};
+
+
+} // namespace stations
+
+
+namespace stations_internal
+{
+
+/** Calls the work and stores what it returns in a result slot. */
+template <typename T, typename TWork>
+class ResultJob
+{
+public:
+  ResultJob(stations::ResultSlot<T> & _slot, TWork _work)
+    : slot(&_slot)
+    , work(std::move(_work))
+  {}
+
+  template <typename ... Args>
+  void
+  operator()(Args && ... args)
+  {
+    slot->set(work(std::forward<Args>(args) ...));
+  }
+
+private:
+  stations::ResultSlot<T> * slot;
+  TWork work;
+};
+
+
+} // namespace stations_internal
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+template <typename T>
+inline
+ResultSlot<T>::ResultSlot()
+  : ready(false)
+{}
+
+
+template <typename T>
+inline
+ResultSlot<T>::~ResultSlot()
+{
+  reset();
+}
+
+
+template <typename T>
+template <typename ... Args>
+void inline
+ResultSlot<T>::set(Args && ... args)
+{
+  new (&storage) T(std::forward<Args>(args) ...);
+  ready.store(true, std::memory_order_release);
+}
+
+
+template <typename T>
+bool inline
+ResultSlot<T>::is_ready() const
+{
+  return ready.load(std::memory_order_acquire);
+}
+
+
+template <typename T>
+void inline
+ResultSlot<T>::wait() const
+{
+  for (std::size_t i = 0; !is_ready(); ++i)
+  {
+    if (i < 1024)
+      stations_internal::cpu_relax();
+    else
+      std::this_thread::yield();
+  }
+}
+
+
+template <typename T>
+inline
+T &
+ResultSlot<T>::get()
+{
+  wait();
+  return *reinterpret_cast<T *>(&storage);
+}
+
+
+template <typename T>
+void inline
+ResultSlot<T>::reset()
+{
+  if (is_ready())
+  {
+    reinterpret_cast<T *>(&storage)->~T();
+    ready.store(false, std::memory_order_relaxed);
+  }
+}
+
+
+template <typename T>
+inline
+Future<T>::Future(ResultSlot<T> & _slot)
+  : slot(&_slot)
+{}
+
+
+template <typename T>
+bool inline
+Future<T>::is_ready() const
+{
+  return slot->is_ready();
+}
+
+
+template <typename T>
+void inline
+Future<T>::wait() const
+{
+  slot->wait();
+}
+
+
+template <typename T>
+inline
+T &
+Future<T>::get() const
+{
+  return slot->get();
+}
+
+
+} // namespace stations
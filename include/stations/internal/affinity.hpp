@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm> // std::find, std::max, std::min
+#include <cstddef> // std::size_t
+#include <fstream> // std::ifstream
+#include <string> // std::string, std::getline, std::stoi, std::to_string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#if defined(__linux__)
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h> // sched_getaffinity, cpu_set_t, CPU_SET, CPU_ISSET
+#endif
+
+
+namespace stations_internal
+{
+
+/** Parses a list of CPUs in the format of Linux, e.g. "0-3,8,10-11". */
+inline
+std::vector<int>
+parse_cpu_list(std::string const & cpu_list)
+{
+  std::vector<int> cpus;
+  std::size_t pos = 0;
+
+  while (pos < cpu_list.size())
+  {
+    std::size_t const end = std::min(cpu_list.find(',', pos), cpu_list.size());
+    std::string const range = cpu_list.substr(pos, end - pos);
+    std::size_t const dash = range.find('-');
+
+    if (range.find_first_of("0123456789") != std::string::npos)
+    {
+      int const first = std::stoi(range.substr(0, dash));
+      int const last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+
+      for (int cpu = first; cpu <= last; ++cpu)
+        cpus.push_back(cpu);
+    }
+
+    pos = end + 1;
+  }
+
+  return cpus;
+}
+
+
+/** Returns the CPUs this process may run on, or an empty list if they cannot be found. */
+inline
+std::vector<int>
+get_allowed_cpus()
+{
+  std::vector<int> cpus;
+
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+  {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (CPU_ISSET(cpu, &cpu_set))
+        cpus.push_back(cpu);
+    }
+  }
+#endif
+
+  return cpus;
+}
+
+
+/**
+ * Returns the CPUs of each NUMA node which this process may run on. The topology is read from sysfs, which is where
+ * libnuma reads it as well, so there is no dependency on libnuma. If it is not there, all allowed CPUs are one node.
+ */
+inline
+std::vector<std::vector<int> >
+get_numa_nodes()
+{
+  std::vector<int> const allowed_cpus = get_allowed_cpus();
+  std::vector<std::vector<int> > nodes;
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string online_nodes;
+
+  if (online && std::getline(online, online_nodes))
+  {
+    for (int const node : parse_cpu_list(online_nodes))
+    {
+      std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      std::string node_cpus;
+      std::vector<int> cpus;
+
+      if (cpulist && std::getline(cpulist, node_cpus))
+      {
+        for (int const cpu : parse_cpu_list(node_cpus))
+        {
+          if (std::find(allowed_cpus.begin(), allowed_cpus.end(), cpu) != allowed_cpus.end())
+            cpus.push_back(cpu);
+        }
+      }
+
+      // Node ids may have gaps, keep the index of each node equal to its id
+      if (nodes.size() <= static_cast<std::size_t>(node))
+        nodes.resize(node + 1);
+
+      nodes[node] = cpus;
+    }
+  }
+
+  if (nodes.empty())
+    nodes.push_back(allowed_cpus);
+
+  return nodes;
+}
+
+
+/** Orders the CPUs node after node, so neighbouring threads share a node. */
+inline
+std::vector<int>
+get_compact_cpu_order(std::vector<std::vector<int> > const & nodes)
+{
+  std::vector<int> cpus;
+
+  for (auto const & node : nodes)
+    cpus.insert(cpus.end(), node.begin(), node.end());
+
+  return cpus;
+}
+
+
+/** Orders the CPUs by taking one from each node in turn, so threads are spread over the nodes. */
+inline
+std::vector<int>
+get_scatter_cpu_order(std::vector<std::vector<int> > const & nodes)
+{
+  std::vector<int> cpus;
+  std::size_t max_node_size = 0;
+
+  for (auto const & node : nodes)
+    max_node_size = std::max(max_node_size, node.size());
+
+  for (std::size_t i = 0; i < max_node_size; ++i)
+  {
+    for (auto const & node : nodes)
+    {
+      if (i < node.size())
+        cpus.push_back(node[i]);
+    }
+  }
+
+  return cpus;
+}
+
+
+/** Lets the thread run only on the CPUs. Returns false if the affinity could not be set, e.g. if the platform does not
+ *  support it or none of the CPUs exist.
+ */
+bool inline
+set_thread_affinity(std::thread & thread, std::vector<int> const & cpus)
+{
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+
+  for (int const cpu : cpus)
+  {
+    if (cpu >= 0 && cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &cpu_set);
+  }
+
+  return CPU_COUNT(&cpu_set) > 0 &&
+         pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+  (void)thread;
+  (void)cpus;
+  return false;
+#endif
+}
+
+
+} // namespace stations_internal
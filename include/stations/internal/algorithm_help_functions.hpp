@@ -1,12 +1,38 @@
 #pragma once
 
-#include <algorithm> // std::sort
+#include <algorithm> // std::max, std::min, std::move, std::sort
 #include <memory> // std::shared_ptr
+#include <utility> // std::move
 
 
 namespace stations_internal
 {
 
+/** Returns its argument, for algorithms which take a transformation or a key but are called without one. */
+struct Identity
+{
+  template <typename T>
+  T const &
+  operator()(T const & value) const
+  {
+    return value;
+  }
+};
+
+
+/** Returns a chunk size which splits a range into a few chunks per thread, so threads which finish early can take
+ *  more work, but not smaller than a thousand elements, so the cost of each job is negligible compared to its work.
+ */
+std::size_t inline
+get_grain_size(std::size_t const container_size, std::size_t const num_threads)
+{
+  std::size_t constexpr CHUNKS_PER_THREAD = 4;
+  std::size_t constexpr MIN_GRAIN_SIZE = 1024;
+  std::size_t const num_chunks = std::max(num_threads, static_cast<std::size_t>(1)) * CHUNKS_PER_THREAD;
+  return std::max(MIN_GRAIN_SIZE, (container_size + num_chunks - 1) / num_chunks);
+}
+
+
 /** Returns a number with a single bit set, the bit set is the most significant bit of the input. If the input is 0, then 1 is returned. Examples:
  * highest_ordered_bit(0) = 1
  * highest_ordered_bit(1) = 1
@@ -29,6 +55,50 @@ highest_ordered_bit(T num)
 }
 
 
+/** Returns how many elements of the sorted range `a` (of length a_len) are among the first `diagonal` elements when it is
+ *  merged with the sorted range `b` (of length b_len). Ties are taken from `a` first, like std::merge does. This is the
+ *  merge path split, which lets threads merge disjoint parts of the output independently.
+ */
+template <typename RandomIt1, typename RandomIt2, typename Compare>
+std::size_t inline
+merge_path_split(RandomIt1 a, std::size_t const a_len, RandomIt2 b, std::size_t const b_len, std::size_t const diagonal,
+                 Compare comp)
+{
+  std::size_t lo = diagonal > b_len ? diagonal - b_len : 0;
+  std::size_t hi = std::min(diagonal, a_len);
+
+  while (lo < hi)
+  {
+    std::size_t const mid = lo + (hi - lo) / 2;
+
+    if (comp(b[diagonal - mid - 1], a[mid]))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  return lo;
+}
+
+
+/** Merges two sorted ranges like std::merge, but moves the elements instead of copying them. */
+template <typename InputIt1, typename InputIt2, typename OutputIt, typename Compare>
+OutputIt inline
+move_merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out, Compare comp)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first2, *first1))
+      *out++ = std::move(*first2++);
+    else
+      *out++ = std::move(*first1++);
+  }
+
+  out = std::move(first1, last1, out);
+  return std::move(first2, last2, out);
+}
+
+
 template <typename TVector>
 void inline
 merge_two_sorted_vectors(std::shared_ptr<TVector> merged, std::shared_ptr<TVector> i1, std::shared_ptr<TVector> i2)
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <utility> // std::move
+
+#include <stations/internal/ring_buffer.hpp> // stations_internal::CACHE_LINE_SIZE
+
+
+namespace stations_internal
+{
+
+/**
+ * A value followed by a cache line of padding. In an array of padded values, no two values share a cache line, so
+ * threads can write to their own value without invalidating the cache lines of the others (false sharing).
+ */
+template <typename T>
+struct PaddedValue
+{
+  T value;
+  bool has_value;
+  char padding[CACHE_LINE_SIZE];
+
+  PaddedValue(T _value)
+    : value(std::move(_value))
+    , has_value(false)
+    , padding()
+  {}
+};
+
+
+} // namespace stations_internal
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm> // std::iter_swap, std::max, std::min
+#include <utility> // std::move
+#include <vector> // std::vector
+
+#include <stations/internal/algorithm_help_functions.hpp> // stations_internal::merge_path_split, move_merge
+#include <stations/internal/uninitialized_buffer.hpp> // stations_internal::ConstructingIterator
+
+#include <stations/tracer.hpp> // stations::named
+
+
+namespace stations_internal
+{
+
+/** Merges the part of the output between two diagonals of the merge path of two neighbouring sorted runs. */
+template <typename SrcIt, typename DstIt, typename Compare>
+class MergePiece
+{
+public:
+  MergePiece(SrcIt _src, DstIt _dst, std::size_t const _a_begin, std::size_t const _b_begin, std::size_t const _b_end,
+             std::size_t const _d_begin, std::size_t const _d_end, Compare _comp)
+    : src(_src)
+    , dst(_dst)
+    , a_begin(_a_begin)
+    , b_begin(_b_begin)
+    , b_end(_b_end)
+    , d_begin(_d_begin)
+    , d_end(_d_end)
+    , comp(_comp)
+  {}
+
+  void
+  operator()()
+  {
+    std::size_t const a_size = b_begin - a_begin;
+    std::size_t const b_size = b_end - b_begin;
+    std::size_t const i_begin = merge_path_split(src + a_begin, a_size, src + b_begin, b_size, d_begin, comp);
+    std::size_t const i_end = merge_path_split(src + a_begin, a_size, src + b_begin, b_size, d_end, comp);
+
+    move_merge(src + a_begin + i_begin, src + a_begin + i_end,
+               src + b_begin + (d_begin - i_begin), src + b_begin + (d_end - i_end),
+               dst + a_begin + d_begin,
+               comp);
+  }
+
+private:
+  SrcIt src;
+  DstIt dst;
+  std::size_t a_begin;
+  std::size_t b_begin;
+  std::size_t b_end;
+  std::size_t d_begin;
+  std::size_t d_end;
+  Compare comp;
+};
+
+
+/**
+ * Calls add_piece with a MergePiece for every piece of every merge of neighbouring sorted runs in `src` into `dst`, at
+ * the same offsets, and the index of the first of the two runs. A run without a neighbour is moved as it is. Each
+ * merge is split into pieces by their merge path, so that all threads get a piece even when there are only a few runs
+ * left. The bounds of the runs are replaced by the bounds of the merged runs.
+ */
+template <typename SrcIt, typename DstIt, typename Compare, typename TAddPiece>
+void inline
+split_merges_of_neighbouring_runs(SrcIt src,
+                                  DstIt dst,
+                                  std::vector<std::size_t> & run_bounds,
+                                  std::size_t const num_threads,
+                                  Compare comp,
+                                  TAddPiece add_piece)
+{
+  std::size_t const num_runs = run_bounds.size() - 1;
+  std::size_t const num_pairs = (num_runs + 1) / 2;
+  std::size_t const pieces_per_pair = std::max(static_cast<std::size_t>(1), (num_threads + num_pairs - 1) / num_pairs);
+  std::vector<std::size_t> merged_bounds;
+  merged_bounds.reserve(num_pairs + 1);
+
+  for (std::size_t r = 0; r < num_runs; r += 2)
+  {
+    std::size_t const a_begin = run_bounds[r];
+    std::size_t const b_begin = run_bounds[r + 1];
+    std::size_t const b_end = r + 2 <= num_runs ? run_bounds[r + 2] : b_begin;
+    std::size_t const merged_size = b_end - a_begin;
+    merged_bounds.push_back(a_begin);
+
+    for (std::size_t p = 0; p < pieces_per_pair; ++p)
+    {
+      std::size_t const d_begin = merged_size * p / pieces_per_pair;
+      std::size_t const d_end = merged_size * (p + 1) / pieces_per_pair;
+
+      if (d_begin == d_end)
+        continue;
+
+      add_piece(MergePiece<SrcIt, DstIt, Compare>(src, dst, a_begin, b_begin, b_end, d_begin, d_end, comp), r);
+    }
+  }
+
+  merged_bounds.push_back(run_bounds.back());
+  run_bounds.swap(merged_bounds);
+}
+
+
+/**
+ * Adds every merge of neighbouring sorted runs in `src` into `dst` to a task graph. run_tasks has the tasks which
+ * write each run. A merge piece depends on the tasks of both its runs, which also makes sure they have finished
+ * reading the part of `dst` which the piece writes. run_tasks is replaced by the tasks writing each merged run.
+ */
+template <typename TGraph, typename SrcIt, typename DstIt, typename Compare>
+void inline
+add_merges_of_neighbouring_runs(TGraph & graph,
+                                SrcIt src,
+                                DstIt dst,
+                                std::vector<std::size_t> & run_bounds,
+                                std::vector<std::vector<std::size_t> > & run_tasks,
+                                std::size_t const num_threads,
+                                Compare comp)
+{
+  using TPiece = MergePiece<SrcIt, DstIt, Compare>;
+  std::vector<std::vector<std::size_t> > merged_run_tasks((run_tasks.size() + 1) / 2);
+
+  split_merges_of_neighbouring_runs(src, dst, run_bounds, num_threads, comp,
+    [&graph, &run_tasks, &merged_run_tasks](TPiece piece, std::size_t const r)
+    {
+      std::size_t const task = graph.add_task(stations::named("merge", std::move(piece)));
+
+      for (std::size_t s = r; s < r + 2 && s < run_tasks.size(); ++s)
+      {
+        for (std::size_t const dependency : run_tasks[s])
+          graph.add_dependency(task, dependency);
+      }
+
+      merged_run_tasks[r / 2].push_back(task);
+    });
+
+  run_tasks.swap(merged_run_tasks);
+}
+
+
+/** Two neighbouring sorted runs in a range, `a` at [first, first + a_size) followed by `b` of b_size elements. */
+struct RunPair
+{
+  std::size_t first;
+  std::size_t a_size;
+  std::size_t b_size;
+};
+
+
+/** Adds jobs to the station which reverse [first + begin, first + end), each swapping up to a grain of pairs. */
+template <typename TStation, typename RandomIt>
+void inline
+add_reversal(TStation & station, RandomIt first, std::size_t const begin, std::size_t const end,
+             std::size_t const num_threads)
+{
+  std::size_t const num_swaps = (end - begin) / 2;
+  std::size_t const grain_size = get_grain_size(num_swaps, num_threads);
+
+  for (std::size_t k = 0; k < num_swaps; k += grain_size)
+  {
+    station.add_work(stations::named("reverse", [first, begin, end](std::size_t const k_begin, std::size_t const k_end)
+      {
+        for (std::size_t i = k_begin; i < k_end; ++i)
+          std::iter_swap(first + (begin + i), first + (end - 1 - i));
+      }), k, std::min(k + grain_size, num_swaps));
+  }
+}
+
+
+/**
+ * Splits every pair of runs which has more than piece_limit elements at the middle of its merge path, until none has.
+ * The part of `a` after the split and the part of `b` before it swap places with a rotation, so both halves are pairs
+ * of runs at the place of their merged output. The rotations of a round are three parallel reversals each. Pairs where
+ * one run is empty are already merged and are dropped.
+ */
+template <typename TStation, typename RandomIt, typename Compare>
+void inline
+split_run_pairs(TStation & station, RandomIt first, std::vector<RunPair> & pairs, std::size_t const piece_limit,
+                std::size_t const num_threads, Compare comp)
+{
+  while (true)
+  {
+    std::vector<RunPair> split_pairs;
+    std::vector<RunPair> rotations; /** Rotate `b` in front of `a`, where `a` and `b` are the parts which swap places */
+
+    for (RunPair const & pair : pairs)
+    {
+      std::size_t const size = pair.a_size + pair.b_size;
+
+      if (pair.a_size == 0 || pair.b_size == 0)
+        continue;
+
+      if (size <= piece_limit)
+      {
+        split_pairs.push_back(pair);
+        continue;
+      }
+
+      std::size_t const diagonal = size / 2;
+      std::size_t const i = merge_path_split(first + pair.first, pair.a_size, first + (pair.first + pair.a_size),
+                                             pair.b_size, diagonal, comp);
+
+      rotations.push_back({pair.first + i, pair.a_size - i, diagonal - i});
+      split_pairs.push_back({pair.first, i, diagonal - i});
+      split_pairs.push_back({pair.first + diagonal, pair.a_size - i, pair.b_size - (diagonal - i)});
+    }
+
+    pairs.swap(split_pairs);
+
+    if (rotations.empty())
+      return;
+
+    // Reversing both parts and then the whole rotates them
+    for (RunPair const & rotation : rotations)
+    {
+      add_reversal(station, first, rotation.first, rotation.first + rotation.a_size, num_threads);
+      add_reversal(station, first, rotation.first + rotation.a_size,
+                   rotation.first + rotation.a_size + rotation.b_size, num_threads);
+    }
+
+    station.wait();
+
+    for (RunPair const & rotation : rotations)
+      add_reversal(station, first, rotation.first, rotation.first + rotation.a_size + rotation.b_size, num_threads);
+
+    station.wait();
+  }
+}
+
+
+/**
+ * Merges every pair of neighbouring sorted runs in the range, until it is sorted, using a buffer of only buffer_size
+ * elements. Pairs are split by their merge path into pieces which can be merged independently, and the pieces are
+ * merged into the buffer and moved back, as many at a time as fit in the buffer. The elements of the buffer are
+ * constructed by each merge and destroyed when they are moved back.
+ */
+template <typename TStation, typename RandomIt, typename T, typename Compare>
+void inline
+merge_runs_in_windows(TStation & station,
+                      RandomIt first,
+                      std::vector<std::size_t> & run_bounds,
+                      T * buffer,
+                      std::size_t const buffer_size,
+                      std::size_t const num_threads,
+                      Compare comp)
+{
+  // Each thread merges a piece of at most its share of the buffer, so every piece fits in the buffer. Without a buffer,
+  // pairs are split until one of their runs is empty, which merges them by rotations alone.
+  std::size_t const num_pieces_in_buffer = std::max(num_threads, static_cast<std::size_t>(1));
+  std::size_t const piece_limit = std::max(static_cast<std::size_t>(1), buffer_size / num_pieces_in_buffer);
+
+  while (run_bounds.size() > 2)
+  {
+    std::vector<RunPair> pairs;
+    std::vector<std::size_t> merged_bounds;
+
+    // A run without a neighbour is already in place
+    for (std::size_t r = 0; r + 1 < run_bounds.size(); r += 2)
+    {
+      merged_bounds.push_back(run_bounds[r]);
+
+      if (r + 2 < run_bounds.size())
+        pairs.push_back({run_bounds[r], run_bounds[r + 1] - run_bounds[r], run_bounds[r + 2] - run_bounds[r + 1]});
+    }
+
+    merged_bounds.push_back(run_bounds.back());
+    run_bounds.swap(merged_bounds);
+    split_run_pairs(station, first, pairs, piece_limit, num_threads, comp);
+
+    for (std::size_t p = 0; p < pairs.size();)
+    {
+      // Merge the next pieces which fit in the buffer together
+      for (std::size_t offset = 0; p < pairs.size() && offset + pairs[p].a_size + pairs[p].b_size <= buffer_size; ++p)
+      {
+        station.add_work(stations::named("merge", [first, comp](RunPair const pair, T * piece_buffer)
+          {
+            std::size_t const size = pair.a_size + pair.b_size;
+            RandomIt const a = first + pair.first;
+            move_merge(a, a + pair.a_size, a + pair.a_size, a + size, ConstructingIterator<T>(piece_buffer), comp);
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              a[i] = std::move(piece_buffer[i]);
+              piece_buffer[i].~T();
+            }
+          }), pairs[p], buffer + offset);
+
+        offset += pairs[p].a_size + pairs[p].b_size;
+      }
+
+      station.wait();
+    }
+  }
+}
+
+
+} // namespace stations_internal
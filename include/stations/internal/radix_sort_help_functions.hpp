@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm> // std::fill, std::move
+#include <cstdint> // std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring> // std::memcpy
+#include <iterator> // std::iterator_traits
+#include <new> // placement new
+#include <type_traits> // std::enable_if, std::integral_constant, std::is_same
+#include <vector> // std::vector
+
+#include <stations/internal/ring_buffer.hpp> // stations_internal::CACHE_LINE_SIZE
+
+#include <stations/arena.hpp> // stations::ArenaScope, stations::MonotonicArena, stations::get_thread_arena
+#include <stations/tracer.hpp> // stations::named
+
+
+namespace stations_internal
+{
+
+std::size_t constexpr RADIX_BITS = 8;
+std::size_t constexpr RADIX_BUCKETS = 1 << RADIX_BITS;
+
+
+template <std::size_t BYTES>
+struct UnsignedOfSize;
+
+template <>
+struct UnsignedOfSize<1> {using type = std::uint8_t;};
+
+template <>
+struct UnsignedOfSize<2> {using type = std::uint16_t;};
+
+template <>
+struct UnsignedOfSize<4> {using type = std::uint32_t;};
+
+template <>
+struct UnsignedOfSize<8> {using type = std::uint64_t;};
+
+
+/** Whether values of type T can be mapped to an unsigned radix key by to_radix_key. Booleans are left out, there is
+ *  nothing to gain from sorting two values by their bytes.
+ */
+template <typename T>
+struct HasRadixKey
+  : std::integral_constant<bool,
+                           (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+                           (std::is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8))>
+{};
+
+
+/** Whether the elements of a range can be radix sorted by their values. The iterator must refer to the elements
+ *  directly, iterators which return a proxy reference, e.g. those of std::vector<bool>, are sorted by comparing.
+ */
+template <typename RandomIt>
+struct IsRadixSortable
+  : std::integral_constant<bool,
+                           HasRadixKey<typename std::iterator_traits<RandomIt>::value_type>::value &&
+                           std::is_same<typename std::iterator_traits<RandomIt>::reference,
+                                        typename std::iterator_traits<RandomIt>::value_type &>::value>
+{};
+
+
+/** Maps a value to an unsigned integer of the same size, such that sorting the keys sorts the values. */
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, T>::type inline
+to_radix_key(T const value)
+{
+  return value;
+}
+
+
+/** Signed integers have their sign bit flipped, so negative values come first. */
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,
+                        typename UnsignedOfSize<sizeof(T)>::type>::type inline
+to_radix_key(T const value)
+{
+  using TKey = typename UnsignedOfSize<sizeof(T)>::type;
+  return static_cast<TKey>(value) ^ (static_cast<TKey>(1) << (sizeof(T) * 8 - 1));
+}
+
+
+/** Positive floating point numbers have their sign bit set, and negative ones have all bits flipped so larger
+ *  magnitudes come first.
+ */
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, typename UnsignedOfSize<sizeof(T)>::type>::type inline
+to_radix_key(T const value)
+{
+  using TKey = typename UnsignedOfSize<sizeof(T)>::type;
+  TKey bits;
+  std::memcpy(&bits, &value, sizeof(T));
+  TKey const sign_bit = static_cast<TKey>(1) << (sizeof(T) * 8 - 1);
+  return (bits & sign_bit) ? static_cast<TKey>(~bits) : static_cast<TKey>(bits | sign_bit);
+}
+
+
+/** Returns the radix bucket of a value in the pass which looks at the bits starting at `shift`. */
+template <typename T, typename KeyExtractor>
+std::size_t inline
+get_radix_bucket(T const & value, KeyExtractor & key, std::size_t const shift)
+{
+  return (to_radix_key(key(value)) >> shift) & (RADIX_BUCKETS - 1);
+}
+
+
+/**
+ * Moves the elements to their buckets in `dst`, starting at the offsets of each bucket. The elements are first
+ * gathered in a small buffer for each bucket, which is written out a cache line at a time. This software write
+ * combining keeps the number of cache lines written to at the same time small.
+ */
+template <typename SrcIt, typename DstIt, typename KeyExtractor>
+void inline
+radix_scatter(SrcIt first, SrcIt last, DstIt dst, std::vector<std::size_t> & offsets, KeyExtractor key,
+              std::size_t const shift)
+{
+  using T = typename std::iterator_traits<SrcIt>::value_type;
+  std::size_t constexpr BUFFER_SIZE = CACHE_LINE_SIZE / sizeof(T);
+
+  if (BUFFER_SIZE < 2)
+  {
+    // Elements fill a cache line on their own, so there is nothing to combine
+    for (; first != last; ++first)
+      dst[offsets[get_radix_bucket(*first, key, shift)]++] = std::move(*first);
+
+    return;
+  }
+
+  // The buffers are scratch memory of the job, so they come from the arena of the thread instead of the heap. Their
+  // elements are constructed when they are buffered and destroyed when they are written out, so T needs no default
+  // constructor.
+  stations::MonotonicArena & arena = stations::get_thread_arena();
+  stations::ArenaScope scratch_scope(arena);
+  T * buffers = static_cast<T *>(arena.allocate(RADIX_BUCKETS * BUFFER_SIZE * sizeof(T), alignof(T)));
+  std::size_t buffered[RADIX_BUCKETS] = {0};
+
+  auto flush = [&buffers, &buffered, &offsets, dst](std::size_t const bucket)
+  {
+    T * buffer = buffers + bucket * BUFFER_SIZE;
+    std::move(buffer, buffer + buffered[bucket], dst + offsets[bucket]);
+    offsets[bucket] += buffered[bucket];
+
+    for (std::size_t i = 0; i < buffered[bucket]; ++i)
+      buffer[i].~T();
+
+    buffered[bucket] = 0;
+  };
+
+  for (; first != last; ++first)
+  {
+    std::size_t const bucket = get_radix_bucket(*first, key, shift);
+    ::new (static_cast<void *>(buffers + bucket * BUFFER_SIZE + buffered[bucket])) T(std::move(*first));
+
+    if (++buffered[bucket] == BUFFER_SIZE)
+      flush(bucket);
+  }
+
+  for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket)
+    flush(bucket);
+}
+
+
+/**
+ * Does one pass of a parallel LSD radix sort, stably moving the elements of `src` to `dst` by their bucket in this
+ * pass. Each part of the range gets its own histogram, which is turned into the offsets where the part writes each
+ * bucket. Returns false, and moves nothing, if every element is in the same bucket so the pass can be skipped.
+ */
+template <typename TStation, typename SrcIt, typename DstIt, typename KeyExtractor>
+bool inline
+radix_sort_pass(TStation & station,
+                SrcIt src,
+                DstIt dst,
+                std::vector<std::size_t> const & part_bounds,
+                std::vector<std::vector<std::size_t> > & histograms,
+                KeyExtractor key,
+                std::size_t const shift)
+{
+  std::size_t const num_parts = part_bounds.size() - 1;
+  std::size_t const container_size = part_bounds.back() - part_bounds.front();
+
+  for (std::size_t p = 0; p < num_parts; ++p)
+  {
+    station.add_work(stations::named("radix histogram", [src, key, shift](std::size_t const first,
+                                                                          std::size_t const last,
+                                                                          std::vector<std::size_t> * histogram) mutable
+      {
+        std::fill(histogram->begin(), histogram->end(), 0);
+
+        for (std::size_t i = first; i < last; ++i)
+          ++(*histogram)[get_radix_bucket(src[i], key, shift)];
+      }), part_bounds[p], part_bounds[p + 1], &histograms[p]);
+  }
+
+  station.wait();
+
+  // Turn the histograms into offsets. Parts write each bucket in order, so the sort is stable.
+  std::size_t offset = 0;
+
+  for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket)
+  {
+    std::size_t const bucket_offset = offset;
+
+    for (std::size_t p = 0; p < num_parts; ++p)
+    {
+      std::size_t const count = histograms[p][bucket];
+      histograms[p][bucket] = offset;
+      offset += count;
+    }
+
+    if (offset - bucket_offset == container_size)
+      return false;
+  }
+
+  for (std::size_t p = 0; p < num_parts; ++p)
+  {
+    station.add_work(stations::named("radix scatter", [src, dst, key, shift](std::size_t const first,
+                                                                             std::size_t const last,
+                                                                             std::vector<std::size_t> * offsets)
+      {
+        radix_scatter(src + first, src + last, dst, *offsets, key, shift);
+      }), part_bounds[p], part_bounds[p + 1], &histograms[p]);
+  }
+
+  station.wait();
+  return true;
+}
+
+
+} // namespace stations_internal
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm> // std::max
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <memory> // std::unique_ptr
+#include <utility> // std::move
+
+#include <stations/internal/algorithm_help_functions.hpp> // stations_internal::highest_ordered_bit
+
+
+namespace stations_internal
+{
+
+/** Size of a cache line on the platforms we care about. Used to pad data which is written by different threads. */
+std::size_t constexpr CACHE_LINE_SIZE = 64;
+
+
+/** Returns the smallest power of two which is larger or equal to the input. If the input is 0, then 1 is returned. */
+template <typename T>
+T inline
+next_power_of_two(T num)
+{
+  T const high = highest_ordered_bit(num);
+  return high == num || num == 0 ? high : high << 1;
+}
+
+
+/**
+ * A bounded lock-free ring buffer with any number of producers and consumers. The slots are allocated once on
+ * construction and reused, so memory usage stays constant no matter how many items pass through the buffer. Each
+ * slot carries a sequence number which tells whether it is ready to be written (sequence == position) or read
+ * (sequence == position + 1), the hand-over of an item is synchronized with acquire/release on that number. A
+ * consumer claims a slot before it moves the item out, so other consumers never see a half-read item. The
+ * capacity is at least two, since with a single slot those two states could not be told apart.
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+  RingBuffer(std::size_t const min_capacity);
+
+  RingBuffer(RingBuffer const &) = delete;
+  RingBuffer & operator=(RingBuffer const &) = delete;
+
+  /** Moves the item into the buffer. Returns false, and leaves the item untouched, if the buffer is full. Safe to call
+   *  from any number of threads.
+   */
+  bool try_push(T & item);
+
+  /** Moves the oldest item out of the buffer. Returns false if the buffer is empty. Safe to call from any number of
+   *  threads.
+   */
+  bool try_pop(T & item);
+
+  std::size_t capacity() const;
+
+private:
+  struct Slot
+  {
+    std::atomic<std::size_t> sequence;
+    T item;
+    char padding[CACHE_LINE_SIZE - (sizeof(std::atomic<std::size_t>) + sizeof(T)) % CACHE_LINE_SIZE];
+  };
+
+  std::size_t const mask;
+  std::unique_ptr<Slot[]> slots;
+  char padding0[CACHE_LINE_SIZE];
+  std::atomic<std::size_t> tail; /** Next position to write, shared by the producers. */
+  char padding1[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+  std::atomic<std::size_t> head; /** Next position to read, shared by the consumers. */
+  char padding2[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+};
+
+
+} // namespace stations_internal
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations_internal
+{
+
+template <typename T>
+inline
+RingBuffer<T>::RingBuffer(std::size_t const min_capacity)
+  : mask(next_power_of_two(std::max(min_capacity, static_cast<std::size_t>(2))) - 1)
+  , slots(new Slot[mask + 1])
+  , tail(0)
+  , head(0)
+{
+  for (std::size_t i = 0; i <= mask; ++i)
+    slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+
+template <typename T>
+bool inline
+RingBuffer<T>::try_push(T & item)
+{
+  std::size_t pos = tail.load(std::memory_order_relaxed);
+  Slot * slot;
+
+  while (true)
+  {
+    slot = &slots[pos & mask];
+    std::size_t const sequence = slot->sequence.load(std::memory_order_acquire);
+    std::ptrdiff_t const diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+    if (diff == 0)
+    {
+      // The slot is free, try to claim it
+      if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+    {
+      return false; // The consumer has not read this slot yet, so the buffer is full
+    }
+    else
+    {
+      pos = tail.load(std::memory_order_relaxed); // Another producer claimed the slot
+    }
+  }
+
+  slot->item = std::move(item);
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+
+template <typename T>
+bool inline
+RingBuffer<T>::try_pop(T & item)
+{
+  std::size_t pos = head.load(std::memory_order_relaxed);
+  Slot * slot;
+
+  while (true)
+  {
+    slot = &slots[pos & mask];
+    std::size_t const sequence = slot->sequence.load(std::memory_order_acquire);
+    std::ptrdiff_t const diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+    if (diff == 0)
+    {
+      // The slot has an item, try to claim it
+      if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+    {
+      return false; // No producer has written this slot yet, so the buffer is empty
+    }
+    else
+    {
+      pos = head.load(std::memory_order_relaxed); // Another consumer claimed the slot
+    }
+  }
+
+  item = std::move(slot->item);
+  slot->item = T(); // Release anything the item holds on to before the slot is reused
+  slot->sequence.store(pos + mask + 1, std::memory_order_release);
+  return true;
+}
+
+
+template <typename T>
+std::size_t inline
+RingBuffer<T>::capacity() const
+{
+  return mask + 1;
+}
+
+
+} // namespace stations_internal
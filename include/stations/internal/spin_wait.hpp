@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <mutex> // std::mutex, std::unique_lock
+
+
+namespace stations_internal
+{
+
+/** Tells the CPU that we are in a spin-wait loop. This saves power and frees resources for a hyper-thread sibling. */
+void inline
+cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile ("yield");
+#endif
+}
+
+
+/**
+ * A place where threads can sleep until a condition becomes true. The thread which makes the condition true must call
+ * notify() afterwards, which is a single atomic load when nobody is sleeping. A sleeper announces itself before it
+ * checks the condition a last time and the notifier changes the condition before checking for sleepers, so with
+ * sequentially consistent atomics either the sleeper sees the change or the notifier sees the sleeper.
+ */
+class Sleeper
+{
+public:
+  Sleeper();
+
+  template <typename Predicate>
+  void sleep_until(Predicate condition);
+
+  void notify_one();
+  void notify_all();
+
+private:
+  std::atomic<std::size_t> num_sleeping;
+  std::mutex mutex;
+  std::condition_variable condition_variable;
+};
+
+
+} // namespace stations_internal
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations_internal
+{
+
+inline
+Sleeper::Sleeper()
+  : num_sleeping(0)
+{}
+
+
+template <typename Predicate>
+void inline
+Sleeper::sleep_until(Predicate condition)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  ++num_sleeping;
+  condition_variable.wait(lock, condition);
+  --num_sleeping;
+}
+
+
+void inline
+Sleeper::notify_one()
+{
+  if (num_sleeping > 0)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    condition_variable.notify_one();
+  }
+}
+
+
+void inline
+Sleeper::notify_all()
+{
+  if (num_sleeping > 0)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    condition_variable.notify_all();
+  }
+}
+
+
+} // namespace stations_internal
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <iterator> // std::random_access_iterator_tag
+#include <memory> // std::allocator
+#include <new> // placement new
+#include <utility> // std::move
+
+
+namespace stations_internal
+{
+
+/**
+ * Memory for a number of elements which are not constructed, so the algorithms can use a buffer for any type which can
+ * be move constructed, without paying for a default constructor they would overwrite anyway. The elements at the start
+ * of the buffer which were constructed in it are destroyed with the buffer.
+ */
+template <typename T>
+class UninitializedBuffer
+{
+public:
+  explicit UninitializedBuffer(std::size_t const _size)
+    : storage(std::allocator<T>().allocate(_size))
+    , size(_size)
+  {}
+
+  ~UninitializedBuffer()
+  {
+    for (std::size_t i = 0; i < num_constructed; ++i)
+      storage[i].~T();
+
+    std::allocator<T>().deallocate(storage, size);
+  }
+
+  UninitializedBuffer(UninitializedBuffer const &) = delete;
+  UninitializedBuffer & operator=(UninitializedBuffer const &) = delete;
+
+  T *
+  get() const
+  {
+    return storage;
+  }
+
+  /** Tells the buffer that its first n elements have been constructed, so they must be destroyed with it. */
+  void
+  set_num_constructed(std::size_t const n)
+  {
+    num_constructed = n;
+  }
+
+private:
+  T * storage;
+  std::size_t size;
+  std::size_t num_constructed = 0;
+};
+
+
+/**
+ * An output iterator over memory where no elements have been constructed. Assigning to an element move or copy
+ * constructs it, so algorithms written for initialized output, e.g. a merge, can fill an UninitializedBuffer.
+ */
+template <typename T>
+class ConstructingIterator
+{
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+
+  class reference
+  {
+  public:
+    explicit reference(T * _element)
+      : element(_element)
+    {}
+
+    reference &
+    operator=(T && value)
+    {
+      ::new (static_cast<void *>(element)) T(std::move(value));
+      return *this;
+    }
+
+    reference &
+    operator=(T const & value)
+    {
+      ::new (static_cast<void *>(element)) T(value);
+      return *this;
+    }
+
+  private:
+    T * element;
+  };
+
+  explicit ConstructingIterator(T * _element)
+    : element(_element)
+  {}
+
+  reference
+  operator*() const
+  {
+    return reference(element);
+  }
+
+  reference
+  operator[](difference_type const n) const
+  {
+    return reference(element + n);
+  }
+
+  ConstructingIterator &
+  operator++()
+  {
+    ++element;
+    return *this;
+  }
+
+  ConstructingIterator
+  operator++(int)
+  {
+    return ConstructingIterator(element++);
+  }
+
+  ConstructingIterator &
+  operator+=(difference_type const n)
+  {
+    element += n;
+    return *this;
+  }
+
+  ConstructingIterator
+  operator+(difference_type const n) const
+  {
+    return ConstructingIterator(element + n);
+  }
+
+  difference_type
+  operator-(ConstructingIterator const & other) const
+  {
+    return element - other.element;
+  }
+
+  bool
+  operator==(ConstructingIterator const & other) const
+  {
+    return element == other.element;
+  }
+
+  bool
+  operator!=(ConstructingIterator const & other) const
+  {
+    return element != other.element;
+  }
+
+private:
+  T * element;
+};
+
+
+} // namespace stations_internal
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <functional> // std::plus
+#include <iterator> // std::distance, std::iterator_traits, std::next
+#include <utility> // std::move
+#include <vector> // std::vector
+
+#include <stations/internal/algorithm_help_functions.hpp> // stations_internal::Identity
+#include <stations/internal/padded_value.hpp> // stations_internal::PaddedValue
+
+#include <stations/partition_iterator.hpp> // stations::get_partition_view
+#include <stations/station_options.hpp> // stations::StationOptions
+#include <stations/thread_pool.hpp> // stations::PooledStation
+
+
+namespace stations_internal
+{
+
+/**
+ * Scans the range into d_first in three steps. First each partition, except the last one, is reduced in parallel.
+ * Then the partition sums are scanned serially, which gives each partition the prefix of everything before it. Last,
+ * each partition is scanned in parallel starting from its prefix. Each element is read before its output is written,
+ * so d_first may be first. An exclusive scan needs an initial prefix, an inclusive one may start without one.
+ */
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+OutputIt inline
+blocked_scan(stations::StationOptions && options,
+             InputIt first,
+             InputIt last,
+             OutputIt d_first,
+             BinaryOp op,
+             PaddedValue<T> prefix,
+             bool const is_inclusive)
+{
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  std::size_t const num_partitions = partitions.num_partitions();
+  std::vector<PaddedValue<T> > sums(num_partitions, prefix);
+  stations::PooledStation scan_station(options);
+
+  // The sum of the last partition is never needed
+  for (std::size_t i = 0; i + 1 < num_partitions; ++i)
+  {
+    if (partitions.partition_first(i) == partitions.partition_last(i))
+      continue;
+
+    scan_station.add_work([op](InputIt first, InputIt last, PaddedValue<T> * sum)
+      {
+        T partition_sum = *first;
+
+        for (++first; first != last; ++first)
+          partition_sum = op(std::move(partition_sum), *first);
+
+        sum->value = std::move(partition_sum);
+        sum->has_value = true;
+      } /*function*/,
+                          partitions.partition_first(i), /*first*/
+                          partitions.partition_last(i), /*last*/
+                          &sums[i]
+                          );
+  }
+
+  scan_station.wait();
+
+  // Replace the sum of each partition with the prefix before it
+  for (auto & sum : sums)
+  {
+    PaddedValue<T> partition_sum = std::move(sum);
+    sum = prefix;
+
+    if (partition_sum.has_value)
+    {
+      prefix.value = prefix.has_value ? op(std::move(prefix.value), std::move(partition_sum.value)) :
+                                        std::move(partition_sum.value);
+      prefix.has_value = true;
+    }
+  }
+
+  for (std::size_t i = 0; i < num_partitions; ++i)
+  {
+    if (partitions.partition_first(i) == partitions.partition_last(i))
+      continue;
+
+    OutputIt d_partition_first = std::next(d_first, std::distance(first, partitions.partition_first(i)));
+
+    scan_station.add_work([op, is_inclusive](InputIt first, InputIt last, OutputIt d_first, PaddedValue<T> * prefix)
+      {
+        T sum = prefix->has_value ? prefix->value : *first;
+
+        if (is_inclusive)
+        {
+          if (prefix->has_value)
+            sum = op(std::move(sum), *first);
+
+          *d_first = sum;
+
+          for (++first, ++d_first; first != last; ++first, ++d_first)
+          {
+            sum = op(std::move(sum), *first);
+            *d_first = sum;
+          }
+        }
+        else
+        {
+          for (; first != last; ++first, ++d_first)
+          {
+            T value = *first; // Read before writing, in case the output is the input
+            *d_first = sum;
+            sum = op(std::move(sum), std::move(value));
+          }
+        }
+      } /*function*/,
+                          partitions.partition_first(i), /*first*/
+                          partitions.partition_last(i), /*last*/
+                          d_partition_first,
+                          &sums[i]
+                          );
+  }
+
+  scan_station.join();
+  return std::next(d_first, std::distance(first, last));
+}
+
+
+} // namespace stations_internal
+
+
+namespace stations
+{
+
+/**
+ * Transforms every element with transform_op and reduces the results, together with init, with reduce_op. Each
+ * partition is reduced by one thread into its own padded result, and the results are then reduced in the order of the
+ * partitions. Therefore reduce_op needs to be associative, but not commutative.
+ */
+template <typename InputIt, typename T, typename BinaryOp, typename UnaryOp>
+T inline
+transform_reduce(StationOptions && options, InputIt first, InputIt last, T init, BinaryOp reduce_op,
+                 UnaryOp transform_op)
+{
+  stations::PartitionView<InputIt> partitions = stations::get_partition_view(first, last, options);
+  std::vector<stations_internal::PaddedValue<T> > partials(partitions.num_partitions(),
+                                                          stations_internal::PaddedValue<T>(init));
+  stations::PooledStation reduce_station(options);
+
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
+  {
+    if (partitions.partition_first(i) == partitions.partition_last(i))
+      continue;
+
+    reduce_station.add_work([reduce_op, transform_op](InputIt first, InputIt last,
+                                                      stations_internal::PaddedValue<T> * partial)
+      {
+        // Accumulate in a local variable, the partial result is only written once
+        T sum = transform_op(*first);
+
+        for (++first; first != last; ++first)
+          sum = reduce_op(std::move(sum), transform_op(*first));
+
+        partial->value = std::move(sum);
+        partial->has_value = true;
+      } /*function*/,
+                            partitions.partition_first(i), /*first*/
+                            partitions.partition_last(i), /*last*/
+                            &partials[i]
+                            );
+  }
+
+  reduce_station.join();
+
+  for (auto & partial : partials)
+  {
+    if (partial.has_value)
+      init = reduce_op(std::move(init), std::move(partial.value));
+  }
+
+  return init;
+}
+
+
+template <typename InputIt, typename T, typename BinaryOp, typename UnaryOp>
+T inline
+transform_reduce(InputIt first, InputIt last, T init, BinaryOp reduce_op, UnaryOp transform_op)
+{
+  StationOptions options;
+  options.chunk_size = 0; // Partition evenly
+  return stations::transform_reduce(std::move(options), first, last, std::move(init), reduce_op, transform_op);
+}
+
+
+/** Reduces the elements, together with init, with op. The op needs to be associative, but not commutative. */
+template <typename InputIt, typename T, typename BinaryOp>
+T inline
+reduce(StationOptions && options, InputIt first, InputIt last, T init, BinaryOp op)
+{
+  return stations::transform_reduce(std::move(options), first, last, std::move(init), op,
+                                    stations_internal::Identity());
+}
+
+
+template <typename InputIt, typename T, typename BinaryOp>
+T inline
+reduce(InputIt first, InputIt last, T init, BinaryOp op)
+{
+  StationOptions options;
+  options.chunk_size = 0; // Partition evenly
+  return stations::reduce(std::move(options), first, last, std::move(init), op);
+}
+
+
+template <typename InputIt, typename T>
+T inline
+reduce(InputIt first, InputIt last, T init)
+{
+  return stations::reduce(first, last, std::move(init), std::plus<T>());
+}
+
+
+template <typename InputIt>
+typename std::iterator_traits<InputIt>::value_type inline
+reduce(InputIt first, InputIt last)
+{
+  using T = typename std::iterator_traits<InputIt>::value_type;
+  return stations::reduce(first, last, T(), std::plus<T>());
+}
+
+
+/** Writes the prefix sums of the range, using op, to d_first. Element i of the output is init op x_0 op ... op x_i. The
+ *  op needs to be associative. The output may be the input, for an in-place scan.
+ */
+template <typename InputIt, typename OutputIt, typename BinaryOp, typename T>
+OutputIt inline
+inclusive_scan(StationOptions && options, InputIt first, InputIt last, OutputIt d_first, BinaryOp op, T init)
+{
+  stations_internal::PaddedValue<T> prefix(std::move(init));
+  prefix.has_value = true;
+  return stations_internal::blocked_scan(std::move(options), first, last, d_first, op, std::move(prefix), true);
+}
+
+
+/** Writes the prefix sums of the range, using op, to d_first. Element i of the output is x_0 op ... op x_i. */
+template <typename InputIt, typename OutputIt, typename BinaryOp>
+OutputIt inline
+inclusive_scan(StationOptions && options, InputIt first, InputIt last, OutputIt d_first, BinaryOp op)
+{
+  using T = typename std::iterator_traits<InputIt>::value_type;
+
+  if (first == last)
+    return d_first;
+
+  // The first element only fills the prefix, which is not used since the prefix has no value
+  return stations_internal::blocked_scan(std::move(options), first, last, d_first, op,
+                                         stations_internal::PaddedValue<T>(*first), true);
+}
+
+
+template <typename InputIt, typename OutputIt, typename BinaryOp, typename T>
+OutputIt inline
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOp op, T init)
+{
+  return stations::inclusive_scan(StationOptions(), first, last, d_first, op, std::move(init));
+}
+
+
+template <typename InputIt, typename OutputIt, typename BinaryOp>
+OutputIt inline
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOp op)
+{
+  return stations::inclusive_scan(StationOptions(), first, last, d_first, op);
+}
+
+
+template <typename InputIt, typename OutputIt>
+OutputIt inline
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first)
+{
+  using T = typename std::iterator_traits<InputIt>::value_type;
+  return stations::inclusive_scan(StationOptions(), first, last, d_first, std::plus<T>());
+}
+
+
+/** Writes the prefix sums of the range, using op, to d_first. Element i of the output is init op x_0 op ... op x_i-1,
+ *  so the first output is init. The op needs to be associative. The output may be the input, for an in-place scan.
+ */
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+OutputIt inline
+exclusive_scan(StationOptions && options, InputIt first, InputIt last, OutputIt d_first, T init, BinaryOp op)
+{
+  stations_internal::PaddedValue<T> prefix(std::move(init));
+  prefix.has_value = true;
+  return stations_internal::blocked_scan(std::move(options), first, last, d_first, op, std::move(prefix), false);
+}
+
+
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+OutputIt inline
+exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init, BinaryOp op)
+{
+  return stations::exclusive_scan(StationOptions(), first, last, d_first, std::move(init), op);
+}
+
+
+template <typename InputIt, typename OutputIt, typename T>
+OutputIt inline
+exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init)
+{
+  return stations::exclusive_scan(StationOptions(), first, last, d_first, std::move(init), std::plus<T>());
+}
+
+
+} // namespace stations
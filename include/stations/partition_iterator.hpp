@@ -1,12 +1,71 @@
 #pragma once
 
-#include <iterator> // std::next
+#include <algorithm> // std::min
+#include <iterator> // std::distance, std::iterator_traits, std::next
 #include <vector> // std::vector
 #include <iostream>
 
 #include <stations/station_options.hpp> // stations::StationOptions
 
 
+namespace stations_internal
+{
+
+/** Returns the number of elements before the boundary of partition `i`, when a range of container_size elements is
+ *  partitioned into num_parts even parts (chunk_size == 0) or chunks of chunk_size elements.
+ */
+std::size_t inline
+get_partition_offset(std::size_t const i,
+                     std::size_t const container_size,
+                     std::size_t const num_parts,
+                     std::size_t const chunk_size)
+{
+  if (chunk_size == 0)
+    return i * (container_size / num_parts) + std::min(i, container_size % num_parts);
+  else
+    return std::min(i * chunk_size, container_size);
+}
+
+
+/** Finds the chunk boundaries arithmetically, since random access iterators can jump to them directly. */
+template <typename RandomIt>
+void inline
+push_chunk_iterators(RandomIt first,
+                     RandomIt last,
+                     std::size_t const chunk_size,
+                     std::vector<RandomIt> & partition_iterators,
+                     std::random_access_iterator_tag)
+{
+  std::size_t const container_size = std::distance(first, last);
+  partition_iterators.reserve((container_size + chunk_size - 1) / chunk_size + 1);
+
+  for (std::size_t offset = 0; offset < container_size; offset += chunk_size)
+    partition_iterators.push_back(first + offset);
+}
+
+
+/** Other iterators need to walk to each chunk boundary. */
+template <typename InputIt>
+void inline
+push_chunk_iterators(InputIt first,
+                     InputIt last,
+                     std::size_t const chunk_size,
+                     std::vector<InputIt> & partition_iterators,
+                     std::input_iterator_tag)
+{
+  while (first != last)
+  {
+    partition_iterators.push_back(first);
+
+    for (std::size_t i = 0; i < chunk_size && first != last; ++i)
+      ++first;
+  }
+}
+
+
+} // namespace stations_internal
+
+
 namespace stations
 {
 
@@ -36,14 +95,8 @@ get_partition_iterators(BidirectionalIterator first,
   }
   else
   {
-    partition_iterators.reserve(std::distance(first,
-                                              last) / options.chunk_size + options.chunk_size + 1);
-
-    for (std::size_t i = 0; first != last; ++i, ++first)
-    {
-      if (i % options.chunk_size == 0)
-        partition_iterators.push_back(first);
-    }
+    stations_internal::push_chunk_iterators(first, last, options.chunk_size, partition_iterators,
+      typename std::iterator_traits<BidirectionalIterator>::iterator_category());
   }
 
   partition_iterators.push_back(last);
@@ -64,4 +117,123 @@ get_partition_iterators(BidirectionalIterator first,
 }
 
 
+/**
+ * The partitions of a range, in the same way as get_partition_iterators splits it. For random access iterators the
+ * boundaries are computed when they are asked for, so no memory is used and nothing is walked up front. Other
+ * iterators have their boundaries found when the view is created.
+ */
+template <typename Iterator>
+class PartitionView
+{
+public:
+  PartitionView(Iterator first, Iterator last, StationOptions const & options);
+
+  std::size_t num_partitions() const;
+  Iterator partition_first(std::size_t const i) const;
+  Iterator partition_last(std::size_t const i) const;
+
+private:
+  Iterator first;
+  std::size_t container_size = 0;
+  std::size_t num_parts = 0;
+  std::size_t chunk_size = 0;
+  std::vector<Iterator> partition_iterators; /** Only used by iterators without random access */
+
+  void init(Iterator last, StationOptions const & options, std::random_access_iterator_tag);
+  void init(Iterator last, StationOptions const & options, std::input_iterator_tag);
+  Iterator get_boundary(std::size_t const i, std::random_access_iterator_tag) const;
+  Iterator get_boundary(std::size_t const i, std::input_iterator_tag) const;
+};
+
+
+template <typename Iterator>
+inline
+PartitionView<Iterator>
+get_partition_view(Iterator first, Iterator last, StationOptions const & options)
+{
+  return PartitionView<Iterator>(first, last, options);
+}
+
+
+} // namespace stations
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+template <typename Iterator>
+inline
+PartitionView<Iterator>::PartitionView(Iterator _first, Iterator last, StationOptions const & options)
+  : first(_first)
+{
+  init(last, options, typename std::iterator_traits<Iterator>::iterator_category());
+}
+
+
+template <typename Iterator>
+std::size_t inline
+PartitionView<Iterator>::num_partitions() const
+{
+  return num_parts;
+}
+
+
+template <typename Iterator>
+Iterator inline
+PartitionView<Iterator>::partition_first(std::size_t const i) const
+{
+  return get_boundary(i, typename std::iterator_traits<Iterator>::iterator_category());
+}
+
+
+template <typename Iterator>
+Iterator inline
+PartitionView<Iterator>::partition_last(std::size_t const i) const
+{
+  return get_boundary(i + 1, typename std::iterator_traits<Iterator>::iterator_category());
+}
+
+
+template <typename Iterator>
+void inline
+PartitionView<Iterator>::init(Iterator last, StationOptions const & options, std::random_access_iterator_tag)
+{
+  container_size = std::distance(first, last);
+  chunk_size = options.chunk_size;
+
+  if (chunk_size == 0)
+    num_parts = options.num_threads;
+  else
+    num_parts = (container_size + chunk_size - 1) / chunk_size;
+}
+
+
+template <typename Iterator>
+void inline
+PartitionView<Iterator>::init(Iterator last, StationOptions const & options, std::input_iterator_tag)
+{
+  partition_iterators = get_partition_iterators(first, last, options);
+  num_parts = partition_iterators.size() - 1;
+}
+
+
+template <typename Iterator>
+Iterator inline
+PartitionView<Iterator>::get_boundary(std::size_t const i, std::random_access_iterator_tag) const
+{
+  return first + stations_internal::get_partition_offset(i, container_size, num_parts, chunk_size);
+}
+
+
+template <typename Iterator>
+Iterator inline
+PartitionView<Iterator>::get_boundary(std::size_t const i, std::input_iterator_tag) const
+{
+  return partition_iterators[i];
+}
+
+
 } // namespace stations
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm> // std::max
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+#include <type_traits> // std::decay
+#include <utility> // std::declval, std::forward, std::move
+#include <vector> // std::vector
+
+#include <stations/internal/spin_wait.hpp> // stations_internal::Sleeper
+
+#include <stations/future.hpp> // stations::ResultSlot
+#include <stations/station_options.hpp> // stations::StationOptions
+#include <stations/thread_pool.hpp> // stations::PooledStation
+
+
+namespace stations
+{
+
+/** Each sink order defines in which order the results of a pipeline are handed to its sink. */
+enum SINK_ORDER
+{
+  PRESERVE_ORDER, /** The sink gets the results in the order the source produced the items. */
+  ANY_ORDER /** The sink gets each result as soon as it is ready, so one slow item does not hold back the others. */
+};
+
+
+} // namespace stations
+
+
+namespace stations_internal
+{
+
+/** Calls the first stage and passes what it returns to the second stage. */
+template <typename TFirst, typename TSecond>
+class ChainedStages
+{
+public:
+  ChainedStages(TFirst _first, TSecond _second)
+    : first(std::move(_first))
+    , second(std::move(_second))
+  {}
+
+  template <typename T>
+  auto
+  operator()(T && item) -> decltype(std::declval<TSecond &>()(std::declval<TFirst &>()(std::forward<T>(item))))
+  {
+    return second(first(std::forward<T>(item)));
+  }
+
+private:
+  TFirst first;
+  TSecond second;
+};
+
+
+template <typename ... TStages>
+struct ChainedStagesType;
+
+template <typename TStage>
+struct ChainedStagesType<TStage>
+{
+  using type = typename std::decay<TStage>::type;
+};
+
+template <typename TStage, typename ... TStages>
+struct ChainedStagesType<TStage, TStages ...>
+{
+  using type = ChainedStages<typename std::decay<TStage>::type, typename ChainedStagesType<TStages ...>::type>;
+};
+
+
+} // namespace stations_internal
+
+
+namespace stations
+{
+
+/** Returns a stage which runs the stages one after another on the same thread, each getting what the previous one
+ *  returned.
+ */
+template <typename TStage>
+typename stations_internal::ChainedStagesType<TStage>::type inline
+chain_stages(TStage && stage)
+{
+  return std::forward<TStage>(stage);
+}
+
+
+template <typename TStage, typename ... TStages>
+typename stations_internal::ChainedStagesType<TStage, TStages ...>::type inline
+chain_stages(TStage && stage, TStages && ... stages)
+{
+  return typename stations_internal::ChainedStagesType<TStage, TStages ...>::type(
+    std::forward<TStage>(stage), stations::chain_stages(std::forward<TStages>(stages) ...));
+}
+
+
+/**
+ * Streams items from a serial source through a parallel stage to a serial sink. The source is called as
+ * `bool source(TItem & item)` and returns false when it has no more items. The stage is called as `stage(TItem &&)`
+ * on the worker threads, any number of items at the same time, and its result is passed to `sink(TResult &&)`. Use
+ * chain_stages to run several stages, and filter by returning fewer elements when the items are chunks. The source
+ * and the sink run on the calling thread, while the workers process the items in between. A hard working boss waits
+ * for room in the queues instead, like a patient boss, so the calling thread never runs a stage when there are workers.
+ *
+ * At most `(num_threads - 1) * max_queue_size` items, and at least two, are between the source and the sink at any
+ * time, which is as many as the queues of the workers hold. The source is not called again until the sink has taken a
+ * result, so memory use stays constant however long the stream is. Returns the number of items the source produced.
+ */
+template <typename TItem, typename TSource, typename TStage, typename TSink>
+std::size_t inline
+run_pipeline(StationOptions && options, TSource source, TStage stage, TSink sink,
+             SINK_ORDER const order = PRESERVE_ORDER)
+{
+  using TResult = typename std::decay<decltype(stage(std::declval<TItem>()))>::type;
+  std::size_t const num_workers = options.num_threads > 0 ? options.num_threads - 1 : 0;
+  std::size_t const num_slots = std::max(static_cast<std::size_t>(2), num_workers * options.max_queue_size);
+  std::vector<ResultSlot<TResult> > slots(num_slots);
+  std::vector<std::size_t> free_slots;
+  std::vector<std::size_t> busy_slots; /** Slots of the items between the source and the sink, oldest first */
+  std::atomic<std::size_t> num_finished(0);
+  stations_internal::Sleeper sleeper; /** Where the calling thread waits for results when it has nothing to do */
+
+  // Neither list grows past the number of slots, so no allocations are made while the stream runs
+  free_slots.reserve(num_slots);
+  busy_slots.reserve(num_slots);
+
+  for (std::size_t s = num_slots; s > 0; --s)
+    free_slots.push_back(s - 1);
+
+  // A job which finishes frees its slot before it leaves its queue, so the queues can look full for a moment
+  if (options.boss_thread_mode == HARD_WORKING_BOSS)
+    options.boss_thread_mode = PATIENT_BOSS;
+
+  stations::PooledStation pipeline_station(options);
+  std::size_t num_items = 0;
+  bool is_source_empty = false;
+
+  while (true)
+  {
+    // Any result which finishes after this point wakes the sleeper below
+    std::size_t const num_seen = num_finished.load();
+    bool made_progress = false;
+
+    for (auto it = busy_slots.begin(); it != busy_slots.end();)
+    {
+      ResultSlot<TResult> & slot = slots[*it];
+
+      if (!slot.is_ready())
+      {
+        if (order == PRESERVE_ORDER)
+          break;
+
+        ++it;
+        continue;
+      }
+
+      sink(std::move(slot.get()));
+      slot.reset();
+      free_slots.push_back(*it);
+      it = busy_slots.erase(it);
+      made_progress = true;
+    }
+
+    while (!is_source_empty && !free_slots.empty())
+    {
+      TItem item;
+
+      if (!source(item))
+      {
+        is_source_empty = true;
+        break;
+      }
+
+      std::size_t const s = free_slots.back();
+      free_slots.pop_back();
+      busy_slots.push_back(s);
+      ++num_items;
+      made_progress = true;
+
+      pipeline_station.add_work([&stage, &num_finished, &sleeper](ResultSlot<TResult> * slot, TItem && item)
+        {
+          slot->set(stage(std::move(item)));
+          ++num_finished;
+          sleeper.notify_one();
+        } /*function*/,
+                                &slots[s], /*slot*/
+                                std::move(item) /*item*/
+                                );
+    }
+
+    if (is_source_empty && busy_slots.empty())
+      break;
+
+    if (!made_progress)
+      sleeper.sleep_until([&num_finished, num_seen]{return num_finished > num_seen;});
+  }
+
+  // The jobs notify the sleeper after their result is ready, so wait for them before it goes out of scope
+  pipeline_station.join();
+  return num_items;
+}
+
+
+template <typename TItem, typename TSource, typename TStage, typename TSink>
+std::size_t inline
+run_pipeline(TSource source, TStage stage, TSink sink, SINK_ORDER const order = PRESERVE_ORDER)
+{
+  return stations::run_pipeline<TItem>(StationOptions(), source, stage, sink, order);
+}
+
+
+} // namespace stations
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm> // std::min, std::move
+#include <iterator> // std::distance, std::iterator_traits
+#include <type_traits> // std::true_type, std::false_type
+#include <vector> // std::vector
+
+#include <stations/internal/algorithm_help_functions.hpp> // stations_internal::Identity
+#include <stations/internal/radix_sort_help_functions.hpp> // stations_internal::radix_sort_pass
+#include <stations/internal/uninitialized_buffer.hpp> // stations_internal::ConstructingIterator, UninitializedBuffer
+
+#include <stations/station_options.hpp> // stations::StationOptions
+#include <stations/thread_pool.hpp> // stations::PooledStation
+#include <stations/tracer.hpp> // stations::named
+
+
+namespace stations
+{
+
+/**
+ * Sorts the range in ascending order of the keys, which the key extractor returns for each element. The keys must be
+ * integers or floating point numbers. This is a stable LSD radix sort, which looks at one byte of the keys in each
+ * pass and skips bytes which are the same for all keys. Needs a buffer as large as the range.
+ */
+template <typename RandomIt, typename KeyExtractor>
+void inline
+radix_sort(StationOptions && options, RandomIt first, RandomIt last, KeyExtractor key)
+{
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  using TKey = decltype(stations_internal::to_radix_key(key(*first)));
+  std::size_t const container_size = std::distance(first, last);
+
+  if (container_size < 2)
+    return;
+
+  // Split the range evenly, each thread counts and moves the elements of one part in every pass
+  std::size_t const num_parts = std::min(options.num_threads, container_size);
+  std::vector<std::size_t> part_bounds;
+
+  for (std::size_t p = 0; p <= num_parts; ++p)
+    part_bounds.push_back(container_size * p / num_parts);
+
+  std::vector<std::vector<std::size_t> > histograms(num_parts,
+                                                    std::vector<std::size_t>(stations_internal::RADIX_BUCKETS));
+  stations_internal::UninitializedBuffer<T> buffer(container_size);
+  bool is_in_buffer = false;
+  bool is_buffer_constructed = false;
+  stations::PooledStation radix_sort_station(options);
+
+  for (std::size_t shift = 0; shift < sizeof(TKey) * 8; shift += stations_internal::RADIX_BITS)
+  {
+    bool moved;
+
+    if (is_in_buffer)
+    {
+      moved = stations_internal::radix_sort_pass(radix_sort_station, buffer.get(), first, part_bounds, histograms, key,
+                                                 shift);
+    }
+    else if (is_buffer_constructed)
+    {
+      moved = stations_internal::radix_sort_pass(radix_sort_station, first, buffer.get(), part_bounds, histograms, key,
+                                                 shift);
+    }
+    else
+    {
+      // The first pass which moves the elements constructs them in the buffer, later passes move into them
+      moved = stations_internal::radix_sort_pass(radix_sort_station, first,
+                                                 stations_internal::ConstructingIterator<T>(buffer.get()),
+                                                 part_bounds, histograms, key, shift);
+      is_buffer_constructed = moved;
+    }
+
+    if (moved)
+      is_in_buffer = !is_in_buffer;
+  }
+
+  if (is_in_buffer)
+  {
+    // Move the sorted elements back, each thread moves one part
+    for (std::size_t p = 0; p < num_parts; ++p)
+    {
+      radix_sort_station.add_work(stations::named("radix move back", [first](T * src_first, T * src_last,
+                                                                              std::size_t const offset)
+        {
+          std::move(src_first, src_last, first + offset);
+        }), buffer.get() + part_bounds[p], buffer.get() + part_bounds[p + 1], part_bounds[p]);
+    }
+
+    radix_sort_station.wait();
+  }
+
+  if (is_buffer_constructed)
+    buffer.set_num_constructed(container_size);
+
+  radix_sort_station.join();
+}
+
+
+template <typename RandomIt>
+void inline
+radix_sort(StationOptions && options, RandomIt first, RandomIt last)
+{
+  stations::radix_sort(std::move(options), first, last, stations_internal::Identity());
+}
+
+
+template <typename RandomIt, typename KeyExtractor>
+void inline
+radix_sort(RandomIt first, RandomIt last, KeyExtractor key)
+{
+  stations::radix_sort(StationOptions(), first, last, key);
+}
+
+
+template <typename RandomIt>
+void inline
+radix_sort(RandomIt first, RandomIt last)
+{
+  stations::radix_sort(StationOptions(), first, last, stations_internal::Identity());
+}
+
+
+} // namespace stations
+
+
+namespace stations_internal
+{
+
+/** Radix sorts the range if it can be radix sorted and a buffer for the range is allowed. Returns false if the
+ *  range was not sorted.
+ */
+template <typename RandomIt>
+bool inline
+try_radix_sort(stations::StationOptions && options, RandomIt first, RandomIt last, std::true_type /*is_radix_sortable*/)
+{
+  if (static_cast<std::size_t>(std::distance(first, last)) > options.max_merge_buffer_size)
+    return false;
+
+  stations::radix_sort(std::move(options), first, last);
+  return true;
+}
+
+
+template <typename RandomIt>
+bool inline
+try_radix_sort(stations::StationOptions &&, RandomIt, RandomIt, std::false_type /*is_radix_sortable*/)
+{
+  return false;
+}
+
+
+} // namespace stations_internal
@@ -1,11 +1,23 @@
 #pragma once
 #include <algorithm> // std::all_of, std::min_element
+#include <atomic> // std::atomic
 #include <iostream> // std::cout
-#include <thread> // std::thread
-#include <utility> // std::forward
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::lock_guard
+#include <thread> // std::thread, std::this_thread::get_id
+#include <type_traits> // std::decay
+#include <utility> // std::forward, std::make_pair, std::pair
+#include <vector> // std::vector
 
+#include <stations/internal/affinity.hpp> // stations_internal::set_thread_affinity
+
+#include <stations/arena.hpp> // stations::MonotonicArena, stations_internal::ArenaSwitch
+#include <stations/future.hpp> // stations::Future, stations::ResultSlot
 #include <stations/station_options.hpp> // stations::WorkerQueue
+#include <stations/station_stats.hpp> // stations::StationStats
 #include <stations/partition_iterator.hpp> // stations::get_partition_iterators
+#include <stations/task.hpp> // stations::Task, stations_internal::bind_job
+#include <stations/tracer.hpp> // stations::TraceScope
 #include <stations/worker_queue.hpp> // stations::WorkerQueue
 
 
@@ -23,9 +35,25 @@ private:
   * STATION STATISTICS *
   *********************/
   bool joined = false;
-  std::size_t main_thread_work_count = 0; /** Number of jobs the main thread has run. */
   std::vector<std::thread> workers; /** List of threads. */
+  stations_internal::Sleeper boss_sleeper; /** Where the boss waits for room in the queues or for work to finish. */
   Queues queues; /** Each thread has a unique worker queue. */
+  std::size_t const id; /** Unique within the process, so threads can remember their boss of this station */
+
+  /** What one thread which adds work does as the boss of the station. Only that thread writes to it, since arenas are
+   *  not thread safe and shared counters would be contended when several threads add work.
+   */
+  struct Boss
+  {
+    MonotonicArena arena; /** What the jobs which the boss runs itself get from get_thread_arena() */
+    std::atomic<std::size_t> inline_executions; /** Number of jobs the boss has run itself */
+    std::atomic<std::size_t> queue_full_events; /** Number of times there was no room in the queues for a job */
+
+    Boss() : inline_executions(0), queue_full_events(0) {}
+  };
+
+  mutable std::mutex bosses_mutex;
+  std::vector<std::pair<std::thread::id, std::unique_ptr<Boss> > > bosses; /** One for each thread which added work */
 
 public:
   StationOptions options; /** Options and policies this station will follow */
@@ -39,16 +67,18 @@ public:
   ***************************/
   Queues::const_iterator find_smallest_queue(std::size_t & smallest_size);
 
+  /** Runs the work with the arguments on some thread. The work and the arguments are moved or copied into a task,
+   *  which has to fit within STATIONS_TASK_SIZE bytes.
+   */
   template <typename TWork, typename ... Args>
   void inline
-  add_work(TWork && work, Args ... args)
+  add_work(TWork && work, Args && ... args)
   {
     if (workers.size() == 0)
     {
-      work(args ...);
-      ++main_thread_work_count;
+      run_on_boss(std::forward<TWork>(work), std::forward<Args>(args) ...);
     }
-    else
+    else if (options.boss_thread_mode == HARD_WORKING_BOSS)
     {
       // We have some workers, so let's assign the work to the smallest worker queue
       std::size_t smallest_size = -1;
@@ -58,68 +88,157 @@ public:
 
       if (smallest_size < options.max_queue_size)
       {
-        (*min_queue_it)->add_work_to_queue([&work, args ...] {work(args ...);});
+        Task job(stations_internal::bind_job(std::forward<TWork>(work), std::forward<Args>(args) ...));
+
+        // Another thread adding work could have filled the queue in the meantime
+        if (!(*min_queue_it)->add_work_to_queue(job))
+        {
+          stations_internal::add_to_own_counter(get_boss().queue_full_events, static_cast<std::size_t>(1));
+          run_on_boss(job);
+        }
       }
       else
       {
-        work(args ...); // If all queues are of maximum size, use the boss thread instead
-        ++main_thread_work_count;
+        // If all queues are of maximum size, use the boss thread instead
+        stations_internal::add_to_own_counter(get_boss().queue_full_events, static_cast<std::size_t>(1));
+        run_on_boss(std::forward<TWork>(work), std::forward<Args>(args) ...);
       }
     }
+    else
+    {
+      Task job(stations_internal::bind_job(std::forward<TWork>(work), std::forward<Args>(args) ...));
+      std::size_t const queue_limit = get_queue_limit();
+
+      // The workers notify the boss sleeper every time an item leaves their queue
+      while (!add_to_smallest_queue(job, queue_limit))
+      {
+        stations_internal::add_to_own_counter(get_boss().queue_full_events, static_cast<std::size_t>(1));
+        boss_sleeper.sleep_until([this, queue_limit]{return has_room_in_queues(queue_limit);});
+      }
+    }
+  }
+
+
+  /** Runs the work with the arguments on some thread, like add_work, and stores what it returns in the slot. The
+   *  returned future can be waited on as soon as this job finishes, without waiting for the other jobs.
+   */
+  template <typename T, typename TWork, typename ... Args>
+  Future<T> inline
+  add_work_with_result(ResultSlot<T> & slot, TWork && work, Args && ... args)
+  {
+    using TJob = stations_internal::ResultJob<T, typename std::decay<TWork>::type>;
+    this->add_work(TJob(slot, std::forward<TWork>(work)), std::forward<Args>(args) ...);
+    return Future<T>(slot);
   }
 
 
   template <typename TWork, typename ... Args>
-  add(TWork && work, Args ... args)
+  void inline
+  add(TWork && work, Args && ... args)
   {
     // For backwards compability
-    this->add_work(std::forward<TWork>(work), args ...);
+    this->add_work(std::forward<TWork>(work), std::forward<Args>(args) ...);
   }
 
 
   template <typename TWork, typename ... Args>
   void inline
-  add_to_thread(std::size_t const thread_id, TWork && work, Args ... args)
+  add_to_thread(std::size_t const thread_id, TWork && work, Args && ... args)
   {
     std::size_t const thread_count = options.num_threads;
 
     if (thread_id % thread_count == thread_count - 1)
     {
-      work(args ...);
-      ++main_thread_work_count;
+      run_on_boss(std::forward<TWork>(work), std::forward<Args>(args) ...);
     }
     else
     {
-      queues[thread_id % thread_count]->add_work_to_queue([&work, args ...] {work(args ...);});
+      Task job(stations_internal::bind_job(std::forward<TWork>(work), std::forward<Args>(args) ...));
+
+      // The queue has a fixed capacity, wait for the worker to make room
+      if (!queues[thread_id % thread_count]->add_work_to_queue(job))
+      {
+        stations_internal::add_to_own_counter(get_boss().queue_full_events, static_cast<std::size_t>(1));
+
+        while (!queues[thread_id % thread_count]->add_work_to_queue(job))
+          std::this_thread::yield();
+      }
     }
   }
 
 
+  /** Waits until every job added so far has finished. Unlike join(), the workers keep running and more work can be
+   *  added afterwards.
+   */
+  void inline
+  wait()
+  {
+    // Jobs are often short, so spin a bit before going to sleep
+    for (std::size_t i = 0; i < 1024 && !has_finished_all_work(); ++i)
+      stations_internal::cpu_relax();
+
+    boss_sleeper.sleep_until([this]{return has_finished_all_work();});
+  }
+
+
   void inline
   join()
   {
-    if (options.verbosity >= 2)
+    for (int i = 0; i < static_cast<int>(options.num_threads) - 1; ++i)
     {
-      std::cout << "[stations] Main thread processed "
-                << main_thread_work_count
-                << " chunks.\n";
+      queues[i]->finish(); // Wakes up the worker if it is sleeping
+      workers[i].join();
     }
 
-    for (int i = 0; i < static_cast<int>(options.num_threads) - 1; ++i)
+    if (options.verbosity >= 2)
+      std::cout << get_stats();
+
+    reset_arenas();
+    joined = true;
+  }
+
+
+  /** Returns what the bosses and each worker have done since the station started. The counters of every thread which
+   *  added work are added up. Reading the stats is safe while jobs are running, but the counters of a worker are only
+   *  updated when it finishes a job or wakes up.
+   */
+  StationStats inline
+  get_stats() const
+  {
+    StationStats stats;
+
     {
-      queues[i]->finished = true;
-      workers[i].join();
+      std::lock_guard<std::mutex> lock(bosses_mutex);
 
-      if (options.verbosity >= 2)
+      for (auto const & boss : bosses)
       {
-        std::cout << "[stations] Thread " << (i + 1)
-                  << " processed "
-                  << queues[i]->get_number_of_completed_items()
-                  << " chunks.\n";
+        stats.boss_inline_executions += boss.second->inline_executions.load(std::memory_order_relaxed);
+        stats.queue_full_events += boss.second->queue_full_events.load(std::memory_order_relaxed);
       }
     }
 
-    joined = true;
+    for (auto const & q : queues)
+      stats.workers.push_back(q->get_stats());
+
+    return stats;
+  }
+
+
+  /** Frees everything the jobs of this station have allocated from their arenas, keeping the memory for later jobs.
+   *  Call it between epochs of work, when no job is running, e.g. after wait().
+   */
+  void inline
+  reset_arenas()
+  {
+    {
+      std::lock_guard<std::mutex> lock(bosses_mutex);
+
+      for (auto & boss : bosses)
+        boss.second->arena.release();
+    }
+
+    for (auto & q : queues)
+      q->arena.release();
   }
 
 
@@ -127,16 +246,52 @@ public:
   * PRIVATE MEMBER FUNCTIONS *
   ****************************/
 private:
+  /** Runs a job on the calling thread. The job allocates from the boss arena of the thread while it runs. */
+  template <typename TWork, typename ... Args>
+  void inline
+  run_on_boss(TWork && work, Args && ... args)
+  {
+    Boss & boss = get_boss();
+    stations_internal::ArenaSwitch arena_switch(boss.arena);
+    TraceScope scope("boss task");
+    work(std::forward<Args>(args) ...);
+    stations_internal::add_to_own_counter(boss.inline_executions, static_cast<std::size_t>(1));
+  }
+
+  Boss & get_boss();
+  std::size_t get_queue_limit() const;
+  bool has_room_in_queues(std::size_t const queue_limit) const;
+  bool has_finished_all_work() const;
+  bool add_to_smallest_queue(Task & job, std::size_t const queue_limit);
+
   void inline
   resize_queues_and_workers(std::size_t const new_size)
   {
+    // Create every queue before starting any worker, since with work stealing the workers look into each other's queues
     for (std::size_t i = 0; i < new_size; ++i)
     {
-      queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+      std::size_t const capacity =
+        options.boss_thread_mode == ORGANIZED_BOSS ? options.queue_capacity : options.max_queue_size;
+
+      queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue(capacity, options.wait_strategy)));
+    }
+
+    for (std::size_t i = 0; i < new_size; ++i)
+    {
+      if (options.scheduling_mode == WORK_STEALING)
+        queues[i]->enable_work_stealing(queues);
+
+      queues[i]->notify_when_items_leave(boss_sleeper);
+
       workers.push_back(std::thread(std::ref(*queues[i])));
     }
+
+    if (options.affinity_mode != NO_AFFINITY || options.numa_node >= 0)
+      pin_workers();
   }
 
+  void pin_workers();
+
 
 };
 
@@ -144,6 +299,21 @@ private:
 } // namespace stations
 
 
+namespace stations_internal
+{
+
+/** Returns a number which no other station of the process has, starting from 1. */
+std::size_t inline
+get_next_station_id()
+{
+  static std::atomic<std::size_t> next_id(1);
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+} // namespace stations_internal
+
+
 /* IMPLEMENTATION */
 
 
@@ -153,18 +323,24 @@ namespace stations
 
 inline
 Station::Station(StationOptions _options)
-  : options(_options)
+  : id(stations_internal::get_next_station_id())
+  , options(_options)
 {
   resize_queues_and_workers(options.num_threads - 1);
+
+  // The thread which creates the station usually adds all its work, so adding work from it never allocates
+  get_boss();
 }
 
 
 inline
 Station::Station(std::size_t const num_threads, std::size_t const max_queue_size)
+  : id(stations_internal::get_next_station_id())
 {
   options.num_threads = num_threads;
   options.max_queue_size = max_queue_size;
   resize_queues_and_workers(options.num_threads - 1);
+  get_boss();
 }
 
 
@@ -200,4 +376,145 @@ Station::find_smallest_queue(std::size_t & smallest_size)
 }
 
 
+/** Returns the arena and counters of the calling thread as the boss of this station. Most jobs are added from a
+ *  single thread, so each thread remembers the boss it was last and only looks it up when the station changes.
+ */
+inline
+Station::Boss &
+Station::get_boss()
+{
+  static thread_local std::pair<std::size_t, Boss *> last_boss(0, nullptr);
+
+  if (last_boss.first == id)
+    return *last_boss.second;
+
+  std::thread::id const thread_id = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(bosses_mutex);
+  Boss * boss = nullptr;
+
+  for (auto const & b : bosses)
+  {
+    if (b.first == thread_id)
+      boss = b.second.get();
+  }
+
+  if (boss == nullptr)
+  {
+    bosses.emplace_back(thread_id, std::unique_ptr<Boss>(new Boss()));
+    boss = bosses.back().second.get();
+  }
+
+  last_boss = std::make_pair(id, boss);
+  return *boss;
+}
+
+
+/** Returns how many items a queue may have before the boss has to wait. An organized boss disregards the max_queue_size
+ *  and fills the queues up to their capacity.
+ */
+std::size_t inline
+Station::get_queue_limit() const
+{
+  if (options.boss_thread_mode == ORGANIZED_BOSS)
+    return queues.front()->function_queue.capacity();
+  else
+    return options.max_queue_size;
+}
+
+
+bool inline
+Station::has_room_in_queues(std::size_t const queue_limit) const
+{
+  for (auto const & q : queues)
+  {
+    if (q->get_number_of_items_in_queue() < queue_limit)
+      return true;
+  }
+
+  return false;
+}
+
+
+/** A job is counted in the size of the queue it was added to until it has finished, and while the boss waits no
+ *  work is added, so the queue sizes only decrease and reading them one after another is safe.
+ */
+bool inline
+Station::has_finished_all_work() const
+{
+  for (auto const & q : queues)
+  {
+    if (q->get_number_of_items_in_queue() > 0)
+      return false;
+  }
+
+  return true;
+}
+
+
+bool inline
+Station::add_to_smallest_queue(Task & job, std::size_t const queue_limit)
+{
+  std::size_t smallest_size = -1;
+  auto min_queue_it = find_smallest_queue(smallest_size);
+  return smallest_size < queue_limit && (*min_queue_it)->add_work_to_queue(job);
+}
+
+
+
+/** Pins each worker to the CPUs the affinity options give it. The CPUs are taken from the ones this process may run on,
+ *  and are reused from the start when there are more workers than CPUs.
+ */
+void inline
+Station::pin_workers()
+{
+  std::vector<std::vector<int> > nodes = stations_internal::get_numa_nodes();
+
+  if (options.numa_node >= 0)
+  {
+    std::size_t const node = options.numa_node;
+    nodes = std::vector<std::vector<int> >(1, node < nodes.size() ? nodes[node] : std::vector<int>());
+  }
+
+  std::vector<int> cpus;
+
+  switch (options.affinity_mode)
+  {
+  case COMPACT_AFFINITY:
+    cpus = stations_internal::get_compact_cpu_order(nodes);
+    break;
+
+  case SCATTER_AFFINITY:
+    cpus = stations_internal::get_scatter_cpu_order(nodes);
+    break;
+
+  case CPU_LIST_AFFINITY:
+    cpus = options.cpu_list;
+    break;
+
+  default: // NO_AFFINITY, so each worker may run on any CPU of the NUMA node
+    for (auto & worker : workers)
+      stations_internal::set_thread_affinity(worker, nodes.front());
+
+    return;
+  }
+
+  if (cpus.empty())
+  {
+    if (options.verbosity >= 1)
+      std::cout << "[stations] WARNING: No CPUs to pin the workers to.\n";
+
+    return;
+  }
+
+  for (std::size_t i = 0; i < workers.size(); ++i)
+  {
+    if (!stations_internal::set_thread_affinity(workers[i], std::vector<int>(1, cpus[(i + 1) % cpus.size()])) &&
+        options.verbosity >= 1)
+    {
+      std::cout << "[stations] WARNING: Could not pin thread " << (i + 1) << " to CPU "
+                << cpus[(i + 1) % cpus.size()] << ".\n";
+    }
+  }
+}
+
 } // namespace stations
@@ -1,34 +1,98 @@
 #pragma once
 
+#include <limits> // std::numeric_limits
 #include <thread> // std::thread
+#include <vector> // std::vector
 
 namespace stations
 {
 
 /** Each boss thread mode defines how the boss thread will react to work if all worker queues are above the max_queue_size. */
-//enum BOSS_THREAD_MODE
-//{
-//  HARD_WORKING_BOSS, /** Boss will do the work. */
-//  PATIENT_BOSS, /** Boss will sleep until any worker queue is below the max_queue_size. */
-//  ORGANIZED_BOSS /** Boss will always add work to the smallest worker queue, disregarding the max_queue_size parameter. */
-//};
+enum BOSS_THREAD_MODE
+{
+  HARD_WORKING_BOSS, /** Boss will do the work. */
+  PATIENT_BOSS, /** Boss will sleep until any worker queue is below the max_queue_size. */
+  ORGANIZED_BOSS /** Boss will always add work to the smallest worker queue, disregarding the max_queue_size parameter. It
+                  *  only sleeps if every queue is filled up to queue_capacity.
+                  */
+};
+
+/** Each wait strategy defines what an idle worker does while its queue is empty. */
+enum WAIT_STRATEGY
+{
+  LOW_LATENCY, /** Worker spins and then yields, but never sleeps. Lowest wake-up latency, but idle cores stay busy. */
+  BALANCED, /** Worker spins briefly, yields a few times and then sleeps until work is added. */
+  POWER_SAVING /** Worker sleeps almost right away when its queue is empty. */
+};
+
+/** Each scheduling mode defines where worker threads look for work. */
+enum SCHEDULING_MODE
+{
+  STATIC_SCHEDULING, /** Jobs are run by the worker whose queue they were added to. */
+  WORK_STEALING /** Workers with an empty queue take the oldest jobs from the queues of other workers. */
+};
+
+/** Each affinity mode defines on which CPUs the worker threads run. The boss thread is never pinned, so the first CPU
+ *  in the order is left for it and worker i gets the CPU after it.
+ */
+enum AFFINITY_MODE
+{
+  NO_AFFINITY, /** Workers run wherever the operating system puts them. */
+  COMPACT_AFFINITY, /** Workers are pinned to CPUs node after node, so they share caches and memory. */
+  SCATTER_AFFINITY, /** Workers are pinned to CPUs taken from each NUMA node in turn, to use the memory bandwidth of all
+                     *  nodes.
+                     */
+  CPU_LIST_AFFINITY /** Workers are pinned to the CPUs in cpu_list, in that order. */
+};
 
 class StationOptions
 {
   friend class Station; /** Allow stations to see your privates. */
 
 public:
-  //BOSS_THREAD_MODE boss_thread_mode = HARD_WORKING_BOSS;
+  BOSS_THREAD_MODE boss_thread_mode = HARD_WORKING_BOSS;
+
+  /** Whether idle worker threads may take work from other queues */
+  SCHEDULING_MODE scheduling_mode = STATIC_SCHEDULING;
+
+  /** What idle worker threads do while waiting for work */
+  WAIT_STRATEGY wait_strategy = BALANCED;
 
   /** Maximum size of the worker queues, including jobs which are running */
   std::size_t max_queue_size = 2;
 
+  /** Number of slots in each worker queue when the boss thread mode is ORGANIZED_BOSS. Other modes use max_queue_size. */
+  std::size_t queue_capacity = 1024;
+
+  /** Largest number of elements stations::sort may allocate as a buffer, to radix sort numbers or to merge the sorted
+   *  partitions. Larger ranges are sorted by comparison and their partitions are merged in pieces which fit in a buffer
+   *  of this size, which needs less memory but moves the elements more often.
+   */
+  std::size_t max_merge_buffer_size = std::numeric_limits<std::size_t>::max();
+
+  /** Where the worker threads run */
+  AFFINITY_MODE affinity_mode = NO_AFFINITY;
+
+  /** CPUs the workers are pinned to when the affinity mode is CPU_LIST_AFFINITY */
+  std::vector<int> cpu_list;
+
+  /** If not negative, workers only run on the CPUs of this NUMA node. With NO_AFFINITY each worker may run on any of
+   *  them, otherwise the CPUs are taken from this node only.
+   */
+  int numa_node = -1;
+
   /** Number of items in each chunk of work to process. If 0, then the work will be evenly distributed among all threads. */
   std::size_t chunk_size = 0;
 
   /** Number of threads to use, including the main thread */
   std::size_t num_threads = std::thread::hardware_concurrency();
 
+  /** If true, the algorithms run on a thread pool which is shared by the whole process, instead of starting and joining
+   *  threads on every call. The pool has a station for each set of options, which is created the first time those
+   *  options are used.
+   */
+  bool use_thread_pool = true;
+
   /** 0 is quite mode, 1 can output warnings, and 2 will output warnings and statistics to
    *  std::cout.
    */
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <ostream> // std::ostream
+#include <vector> // std::vector
+
+
+namespace stations
+{
+
+/** What one thread of a station has done since the station started. Times are in nanoseconds. */
+struct ThreadStats
+{
+  std::size_t tasks_executed = 0;
+  std::uint64_t busy_ns = 0; /** Time spent running tasks */
+  std::uint64_t idle_ns = 0; /** Time between tasks, including the time asleep */
+  std::uint64_t sleep_ns = 0; /** Time asleep, waiting for work to be added */
+  std::uint64_t queue_wait_ns = 0; /** Sum of the times the tasks waited in a queue before they started */
+
+  ThreadStats & operator+=(ThreadStats const & other);
+};
+
+
+/** What a station has done since it started, e.g. to tune max_queue_size and chunk_size from real traffic. */
+struct StationStats
+{
+  std::vector<ThreadStats> workers; /** One for each worker thread */
+  std::size_t boss_inline_executions = 0; /** Number of tasks the boss thread ran itself */
+  std::size_t queue_full_events = 0; /** Number of times the boss found no room in the queues for a task */
+
+  /** Returns the sum of the stats of all workers. */
+  ThreadStats get_worker_total() const;
+};
+
+
+std::ostream & operator<<(std::ostream & out, StationStats const & stats);
+
+
+} // namespace stations
+
+
+namespace stations_internal
+{
+
+/**
+ * Adds to a counter which only one thread writes, with a plain load and store instead of an atomic read-modify-write.
+ * Other threads can still read the counter safely, so collecting stats costs no shared atomic operations.
+ */
+template <typename T>
+void inline
+add_to_own_counter(std::atomic<T> & counter, T const value)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+
+/** The stats of a worker, which only the worker thread writes. */
+struct ThreadCounters
+{
+  std::atomic<std::size_t> tasks_executed;
+  std::atomic<std::uint64_t> busy_ns;
+  std::atomic<std::uint64_t> idle_ns;
+  std::atomic<std::uint64_t> sleep_ns;
+  std::atomic<std::uint64_t> queue_wait_ns;
+
+  ThreadCounters()
+    : tasks_executed(0)
+    , busy_ns(0)
+    , idle_ns(0)
+    , sleep_ns(0)
+    , queue_wait_ns(0)
+  {}
+
+  stations::ThreadStats
+  get_stats() const
+  {
+    stations::ThreadStats stats;
+    stats.tasks_executed = tasks_executed.load(std::memory_order_relaxed);
+    stats.busy_ns = busy_ns.load(std::memory_order_relaxed);
+    stats.idle_ns = idle_ns.load(std::memory_order_relaxed);
+    stats.sleep_ns = sleep_ns.load(std::memory_order_relaxed);
+    stats.queue_wait_ns = queue_wait_ns.load(std::memory_order_relaxed);
+    return stats;
+  }
+};
+
+
+} // namespace stations_internal
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+inline
+ThreadStats &
+ThreadStats::operator+=(ThreadStats const & other)
+{
+  tasks_executed += other.tasks_executed;
+  busy_ns += other.busy_ns;
+  idle_ns += other.idle_ns;
+  sleep_ns += other.sleep_ns;
+  queue_wait_ns += other.queue_wait_ns;
+  return *this;
+}
+
+
+ThreadStats inline
+StationStats::get_worker_total() const
+{
+  ThreadStats total;
+
+  for (auto const & worker : workers)
+    total += worker;
+
+  return total;
+}
+
+
+inline
+std::ostream &
+operator<<(std::ostream & out, StationStats const & stats)
+{
+  out << "[stations] Main thread processed " << stats.boss_inline_executions << " chunks.\n";
+
+  for (std::size_t i = 0; i < stats.workers.size(); ++i)
+  {
+    ThreadStats const & worker = stats.workers[i];
+    out << "[stations] Thread " << (i + 1) << " processed " << worker.tasks_executed << " chunks, busy "
+        << worker.busy_ns / 1000000.0 << " ms, idle " << worker.idle_ns / 1000000.0 << " ms ("
+        << worker.sleep_ns / 1000000.0 << " ms asleep), tasks waited " << worker.queue_wait_ns / 1000000.0
+        << " ms in the queue.\n";
+  }
+
+  out << "[stations] The queues were full " << stats.queue_full_events << " times.\n";
+  return out;
+}
+
+
+} // namespace stations
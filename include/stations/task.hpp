@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstddef> // std::size_t, std::max_align_t
+#include <new> // placement new
+#include <tuple> // std::tuple, std::get
+#include <type_traits> // std::aligned_storage, std::decay, std::enable_if
+#include <utility> // std::forward, std::move
+
+/** Number of bytes a job can capture and still be stored in a task. Can be increased on the command line. */
+#ifndef STATIONS_TASK_SIZE
+#define STATIONS_TASK_SIZE 128
+#endif
+
+
+namespace stations_internal
+{
+
+template <std::size_t ... I>
+struct IndexSequence {};
+
+template <std::size_t N, std::size_t ... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I ...> {};
+
+template <std::size_t ... I>
+struct MakeIndexSequence<0, I ...>
+{
+  using type = IndexSequence<I ...>;
+};
+
+
+/** A function together with the arguments it will be called with. The arguments are moved into the call, since a job
+ *  only runs once.
+ */
+template <typename TWork, typename ... Args>
+class BoundJob
+{
+public:
+  template <typename TWorkArg, typename ... ArgsArg>
+  BoundJob(TWorkArg && _work, ArgsArg && ... _args)
+    : work(std::forward<TWorkArg>(_work))
+    , args(std::forward<ArgsArg>(_args) ...)
+  {}
+
+  void
+  operator()()
+  {
+    call(typename MakeIndexSequence<sizeof ... (Args)>::type());
+  }
+
+private:
+  TWork work;
+  std::tuple<Args ...> args;
+
+  template <std::size_t ... I>
+  void
+  call(IndexSequence<I ...>)
+  {
+    work(std::move(std::get<I>(args)) ...);
+  }
+};
+
+
+template <typename TWork, typename ... Args>
+BoundJob<typename std::decay<TWork>::type, typename std::decay<Args>::type ...> inline
+bind_job(TWork && work, Args && ... args)
+{
+  return BoundJob<typename std::decay<TWork>::type, typename std::decay<Args>::type ...>(
+    std::forward<TWork>(work), std::forward<Args>(args) ...);
+}
+
+
+} // namespace stations_internal
+
+
+namespace stations
+{
+
+/**
+ * A move-only callable which stores the job inside itself instead of on the heap, unlike std::function. Jobs which do
+ * not fit in SIZE bytes are rejected at compile time, so creating and moving tasks never allocates.
+ */
+template <std::size_t SIZE>
+class BasicTask
+{
+public:
+  BasicTask();
+
+  template <typename TJob,
+            typename = typename std::enable_if<!std::is_same<typename std::decay<TJob>::type, BasicTask>::value>::type>
+  BasicTask(TJob && job);
+
+  BasicTask(BasicTask && other);
+  BasicTask & operator=(BasicTask && other);
+  ~BasicTask();
+
+  BasicTask(BasicTask const &) = delete;
+  BasicTask & operator=(BasicTask const &) = delete;
+
+  void operator()();
+  explicit operator bool() const;
+  void reset();
+
+private:
+  /** How to run, move and destroy the type of job which is stored */
+  struct Operations
+  {
+    void (* invoke)(void *);
+    void (* move)(void * to, void * from);
+    void (* destroy)(void *);
+  };
+
+  template <typename TJob>
+  struct JobOperations
+  {
+    static void invoke(void * job) {(*static_cast<TJob *>(job))();}
+    static void move(void * to, void * from) {new (to) TJob(std::move(*static_cast<TJob *>(from)));}
+    static void destroy(void * job) {static_cast<TJob *>(job)->~TJob();}
+    static Operations const operations;
+  };
+
+  typename std::aligned_storage<SIZE, alignof(std::max_align_t)>::type storage;
+  Operations const * operations;
+};
+
+
+/** The task type stations use for their jobs. */
+using Task = BasicTask<STATIONS_TASK_SIZE>;
+
+
+} // namespace stations
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+template <std::size_t SIZE>
+template <typename TJob>
+typename BasicTask<SIZE>::Operations const BasicTask<SIZE>::JobOperations<TJob>::operations = {
+  &BasicTask<SIZE>::JobOperations<TJob>::invoke,
+  &BasicTask<SIZE>::JobOperations<TJob>::move,
+  &BasicTask<SIZE>::JobOperations<TJob>::destroy
+};
+
+
+template <std::size_t SIZE>
+inline
+BasicTask<SIZE>::BasicTask()
+  : operations(nullptr)
+{}
+
+
+template <std::size_t SIZE>
+template <typename TJob, typename>
+inline
+BasicTask<SIZE>::BasicTask(TJob && job)
+{
+  using TStored = typename std::decay<TJob>::type;
+  static_assert(sizeof(TStored) <= SIZE,
+                "The job is too large to be stored in a task, capture less or increase STATIONS_TASK_SIZE.");
+  static_assert(alignof(TStored) <= alignof(std::max_align_t), "The job is over-aligned.");
+
+  new (&storage) TStored(std::forward<TJob>(job));
+  operations = &JobOperations<TStored>::operations;
+}
+
+
+template <std::size_t SIZE>
+inline
+BasicTask<SIZE>::BasicTask(BasicTask && other)
+  : operations(other.operations)
+{
+  if (operations)
+  {
+    operations->move(&storage, &other.storage);
+    other.reset();
+  }
+}
+
+
+template <std::size_t SIZE>
+inline
+BasicTask<SIZE> &
+BasicTask<SIZE>::operator=(BasicTask && other)
+{
+  if (this != &other)
+  {
+    reset();
+
+    if (other.operations)
+    {
+      other.operations->move(&storage, &other.storage);
+      operations = other.operations;
+      other.reset();
+    }
+  }
+
+  return *this;
+}
+
+
+template <std::size_t SIZE>
+inline
+BasicTask<SIZE>::~BasicTask()
+{
+  reset();
+}
+
+
+template <std::size_t SIZE>
+void inline
+BasicTask<SIZE>::operator()()
+{
+  operations->invoke(&storage);
+}
+
+
+template <std::size_t SIZE>
+inline
+BasicTask<SIZE>::operator bool() const
+{
+  return operations != nullptr;
+}
+
+
+/** Destroys the stored job, releasing anything it has captured. */
+template <std::size_t SIZE>
+void inline
+BasicTask<SIZE>::reset()
+{
+  if (operations)
+  {
+    operations->destroy(&storage);
+    operations = nullptr;
+  }
+}
+
+
+} // namespace stations
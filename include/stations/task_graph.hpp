@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <memory> // std::unique_ptr
+#include <utility> // std::forward
+#include <vector> // std::vector
+
+#include <stations/internal/ring_buffer.hpp> // stations_internal::RingBuffer
+#include <stations/internal/spin_wait.hpp> // stations_internal::Sleeper
+
+#include <stations/task.hpp> // stations::Task, stations_internal::bind_job
+
+
+namespace stations
+{
+
+/**
+ * Tasks with dependencies between them. When the graph is run on a station, every task is added to the station as
+ * soon as all the tasks it depends on have finished, so there is no barrier between phases of the work. Only the
+ * thread calling run() adds tasks to the station. The workers hand it the tasks which became ready through a ring
+ * buffer, which has room for every task. A graph runs once, since the tasks may move their arguments into the call.
+ */
+class TaskGraph
+{
+public:
+  TaskGraph();
+
+  TaskGraph(TaskGraph const &) = delete;
+  TaskGraph & operator=(TaskGraph const &) = delete;
+
+  /** Adds a task which calls the work with the arguments. Returns the id of the task. */
+  template <typename TWork, typename ... Args>
+  std::size_t add_task(TWork && work, Args && ... args);
+
+  /** The task will not start before the dependency has finished. */
+  void add_dependency(std::size_t const task, std::size_t const dependency);
+
+  std::size_t size() const;
+  bool has_cycle() const;
+
+  /** Runs all the tasks on the station, and returns once they have all finished. Returns false, and runs nothing, if
+   *  the dependencies have a cycle.
+   */
+  template <typename TStation>
+  bool run(TStation & station);
+
+private:
+  std::vector<Task> tasks;
+  std::vector<std::vector<std::size_t> > dependents; /** Tasks which depend on each task */
+  std::vector<std::size_t> num_dependencies;
+  std::unique_ptr<std::atomic<std::size_t>[]> num_unfinished_dependencies;
+  std::unique_ptr<stations_internal::RingBuffer<std::size_t> > ready_tasks;
+  std::atomic<std::size_t> num_ready; /** Number of tasks which have been put in the ready_tasks buffer */
+  stations_internal::Sleeper sleeper; /** Where run() waits for tasks to become ready */
+
+  void run_task(std::size_t const task);
+  void make_ready(std::size_t const task);
+};
+
+
+} // namespace stations
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+inline
+TaskGraph::TaskGraph()
+  : num_ready(0)
+{}
+
+
+template <typename TWork, typename ... Args>
+std::size_t inline
+TaskGraph::add_task(TWork && work, Args && ... args)
+{
+  tasks.push_back(Task(stations_internal::bind_job(std::forward<TWork>(work), std::forward<Args>(args) ...)));
+  dependents.push_back(std::vector<std::size_t>());
+  num_dependencies.push_back(0);
+  return tasks.size() - 1;
+}
+
+
+void inline
+TaskGraph::add_dependency(std::size_t const task, std::size_t const dependency)
+{
+  dependents[dependency].push_back(task);
+  ++num_dependencies[task];
+}
+
+
+std::size_t inline
+TaskGraph::size() const
+{
+  return tasks.size();
+}
+
+
+/** Checks whether every task can be reached by starting from the tasks without dependencies (Kahn's algorithm). */
+bool inline
+TaskGraph::has_cycle() const
+{
+  std::vector<std::size_t> remaining = num_dependencies;
+  std::vector<std::size_t> ready;
+
+  for (std::size_t t = 0; t < tasks.size(); ++t)
+  {
+    if (remaining[t] == 0)
+      ready.push_back(t);
+  }
+
+  std::size_t num_reached = 0;
+
+  while (!ready.empty())
+  {
+    std::size_t const t = ready.back();
+    ready.pop_back();
+    ++num_reached;
+
+    for (std::size_t const dependent : dependents[t])
+    {
+      if (--remaining[dependent] == 0)
+        ready.push_back(dependent);
+    }
+  }
+
+  return num_reached != tasks.size();
+}
+
+
+template <typename TStation>
+bool inline
+TaskGraph::run(TStation & station)
+{
+  std::size_t const num_tasks = tasks.size();
+
+  if (num_tasks == 0)
+    return true;
+
+  if (has_cycle())
+    return false;
+
+  num_unfinished_dependencies.reset(new std::atomic<std::size_t>[num_tasks]);
+  ready_tasks.reset(new stations_internal::RingBuffer<std::size_t>(num_tasks));
+
+  for (std::size_t t = 0; t < num_tasks; ++t)
+    num_unfinished_dependencies[t].store(num_dependencies[t], std::memory_order_relaxed);
+
+  for (std::size_t t = 0; t < num_tasks; ++t)
+  {
+    if (num_dependencies[t] == 0)
+      make_ready(t);
+  }
+
+  std::size_t num_added = 0;
+
+  while (true)
+  {
+    std::size_t task;
+
+    while (ready_tasks->try_pop(task))
+    {
+      station.add_work([this](std::size_t const t){run_task(t);}, task);
+      ++num_added;
+    }
+
+    if (num_added == num_tasks)
+      break;
+
+    // A task is pushed before it is counted, so once the count is larger than the number added there is one to pop
+    sleeper.sleep_until([this, num_added]{return num_ready > num_added;});
+  }
+
+  station.wait();
+  return true;
+}
+
+
+void inline
+TaskGraph::run_task(std::size_t const task)
+{
+  tasks[task]();
+  tasks[task].reset();
+
+  for (std::size_t const dependent : dependents[task])
+  {
+    if (num_unfinished_dependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+      make_ready(dependent);
+  }
+}
+
+
+void inline
+TaskGraph::make_ready(std::size_t const task)
+{
+  std::size_t ready_task = task;
+  ready_tasks->try_push(ready_task); // Never full, since every task is pushed once
+  ++num_ready;
+  sleeper.notify_one();
+}
+
+
+} // namespace stations
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <iostream> // std::cout
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::lock_guard
+#include <utility> // std::forward
+#include <vector> // std::vector
+
+#include <stations/station.hpp> // stations::Station
+#include <stations/station_options.hpp> // stations::StationOptions
+
+
+namespace stations_internal
+{
+
+/** A station of the thread pool, and whether an algorithm is using it. */
+struct PoolEntry
+{
+  explicit PoolEntry(stations::StationOptions const & options)
+    : station(options)
+    , in_use(false)
+  {}
+
+  stations::Station station;
+
+  /** Taken with an exchange instead of a mutex, so a thread which already uses the station, e.g. when the boss runs a
+   *  job of a pooled algorithm which runs another algorithm, fails to take it instead of locking it again.
+   */
+  std::atomic<bool> in_use;
+};
+
+
+/** The process-wide stations the algorithms share, one for each set of options a station is created with. The mutex
+ *  is only held while a station is looked up or created, so algorithms with different options use the pool at the
+ *  same time.
+ */
+struct ThreadPool
+{
+  std::mutex mutex;
+  std::vector<std::unique_ptr<PoolEntry> > entries;
+};
+
+
+/** Returns true if stations created with the two options behave the same. Options which only the algorithms read, e.g.
+ *  the chunk_size, are not compared.
+ */
+bool inline
+has_same_station_options(stations::StationOptions const & a, stations::StationOptions const & b)
+{
+  return a.boss_thread_mode == b.boss_thread_mode &&
+         a.scheduling_mode == b.scheduling_mode &&
+         a.wait_strategy == b.wait_strategy &&
+         a.max_queue_size == b.max_queue_size &&
+         a.queue_capacity == b.queue_capacity &&
+         a.affinity_mode == b.affinity_mode &&
+         a.cpu_list == b.cpu_list &&
+         a.numa_node == b.numa_node &&
+         a.num_threads == b.num_threads &&
+         a.verbosity == b.verbosity;
+}
+
+
+inline
+ThreadPool &
+get_thread_pool()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+
+} // namespace stations_internal
+
+
+namespace stations
+{
+
+/**
+ * The station an algorithm runs its jobs on. If the options allow it, this borrows a station from the thread pool which
+ * is shared by the whole process, so no threads are started or joined. The pool has a station for each set of options
+ * the algorithms have asked for, which is created the first time those options are used. If the station with these
+ * options is already in use, e.g. by another thread or by an algorithm which is running this one, a new station is
+ * created instead.
+ */
+class PooledStation
+{
+public:
+  PooledStation(StationOptions const & options);
+  ~PooledStation();
+
+  PooledStation(PooledStation const &) = delete;
+  PooledStation & operator=(PooledStation const &) = delete;
+
+  template <typename TWork, typename ... Args>
+  void inline
+  add_work(TWork && work, Args && ... args)
+  {
+    station->add_work(std::forward<TWork>(work), std::forward<Args>(args) ...);
+  }
+
+  template <typename T, typename TWork, typename ... Args>
+  Future<T> inline
+  add_work_with_result(ResultSlot<T> & slot, TWork && work, Args && ... args)
+  {
+    return station->add_work_with_result(slot, std::forward<TWork>(work), std::forward<Args>(args) ...);
+  }
+
+  /** Waits until all the work added so far has finished. More work can be added afterwards. */
+  void wait();
+
+  /** Waits until all the work has finished, and gives the station back to the pool. Memory the jobs allocated from
+   *  their arenas is freed. With a verbosity of 2 the stats are printed, which for a station from the pool include the
+   *  work of every algorithm which has used it.
+   */
+  void join();
+  bool is_pooled() const;
+  Station & get_station();
+
+  /** Returns the stats of the station. A station from the pool counts the work of every algorithm which used it. */
+  StationStats get_stats() const;
+
+private:
+  stations_internal::PoolEntry * entry = nullptr; /** The entry of the station if it is from the pool */
+  std::unique_ptr<Station> own_station;
+  Station * station = nullptr;
+  bool pooled = false;
+  bool joined = false;
+};
+
+
+} // namespace stations
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+inline
+PooledStation::PooledStation(StationOptions const & options)
+{
+  if (options.use_thread_pool)
+  {
+    stations_internal::ThreadPool & pool = stations_internal::get_thread_pool();
+    stations_internal::PoolEntry * matching_entry = nullptr;
+
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex);
+
+      for (auto const & pool_entry : pool.entries)
+      {
+        if (stations_internal::has_same_station_options(pool_entry->station.options, options))
+        {
+          matching_entry = pool_entry.get();
+          break;
+        }
+      }
+
+      if (matching_entry == nullptr)
+      {
+        pool.entries.emplace_back(new stations_internal::PoolEntry(options));
+        matching_entry = pool.entries.back().get();
+      }
+    }
+
+    if (!matching_entry->in_use.exchange(true, std::memory_order_acquire))
+    {
+      entry = matching_entry;
+      station = &entry->station;
+      pooled = true;
+      return;
+    }
+  }
+
+  own_station.reset(new Station(options));
+  station = own_station.get();
+}
+
+
+inline
+PooledStation::~PooledStation()
+{
+  if (not joined)
+    join();
+}
+
+
+void inline
+PooledStation::wait()
+{
+  station->wait();
+}
+
+
+void inline
+PooledStation::join()
+{
+  if (pooled)
+  {
+    station->wait();
+
+    if (station->options.verbosity >= 2)
+      std::cout << station->get_stats();
+
+    station->reset_arenas();
+    entry->in_use.store(false, std::memory_order_release);
+  }
+  else
+  {
+    station->join();
+  }
+
+  joined = true;
+}
+
+
+StationStats inline
+PooledStation::get_stats() const
+{
+  return station->get_stats();
+}
+
+
+bool inline
+PooledStation::is_pooled() const
+{
+  return pooled;
+}
+
+
+inline
+Station &
+PooledStation::get_station()
+{
+  return *station;
+}
+
+
+} // namespace stations
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <ostream> // std::ostream
+#include <utility> // std::declval, std::forward, std::move
+
+#ifdef STATIONS_TRACE
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::steady_clock
+#include <cstdint> // std::uint64_t
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::lock_guard
+#include <type_traits> // std::decay
+#include <vector> // std::vector
+#endif
+
+/**
+ * Tracing is compiled in only when STATIONS_TRACE is defined, e.g. with -DSTATIONS_TRACE on the command line.
+ * Otherwise every function in this file does nothing and costs nothing. All translation units of a program must agree
+ * on it.
+ */
+
+/** Number of events each thread keeps. When a thread records more, its oldest events are overwritten. */
+#ifndef STATIONS_TRACE_BUFFER_SIZE
+#define STATIONS_TRACE_BUFFER_SIZE 65536
+#endif
+
+
+#ifdef STATIONS_TRACE
+
+namespace stations_internal
+{
+
+/** A slice of time a thread spent on something, or an instant if it has no duration. */
+struct TraceEvent
+{
+  char const * name;
+  std::uint64_t start_ns;
+  std::uint64_t duration_ns;
+  bool is_instant;
+};
+
+
+/**
+ * The events of one thread, in a ring which only that thread writes to, so recording an event takes no locks and no
+ * atomic read-modify-write. The events may be read by another thread once the writer has stopped, e.g. after a join.
+ */
+class TraceBuffer
+{
+public:
+  explicit TraceBuffer(std::size_t const _id)
+    : events(new TraceEvent[STATIONS_TRACE_BUFFER_SIZE])
+    , num_events(0)
+    , id(_id)
+  {}
+
+  void
+  record(TraceEvent const & event)
+  {
+    std::size_t const n = num_events.load(std::memory_order_relaxed);
+    events[n % STATIONS_TRACE_BUFFER_SIZE] = event;
+    num_events.store(n + 1, std::memory_order_release);
+  }
+
+  std::unique_ptr<TraceEvent[]> events;
+  std::atomic<std::size_t> num_events; /** Number of events ever recorded, the ring holds the last ones */
+  std::size_t const id; /** Shown as the thread id in the trace */
+};
+
+
+/** Every trace buffer there is. Buffers of threads which have exited are reused by new threads, so the number of
+ *  buffers is the largest number of threads which have traced at the same time.
+ */
+struct TraceRegistry
+{
+  std::mutex mutex;
+  std::vector<std::unique_ptr<TraceBuffer> > buffers;
+  std::vector<TraceBuffer *> free_buffers;
+};
+
+
+/** The registry is never destroyed, since threads give their buffers back when they exit, and the workers of the thread
+ *  pool exit while the static objects are destroyed.
+ */
+inline
+TraceRegistry &
+get_trace_registry()
+{
+  static TraceRegistry * registry = new TraceRegistry();
+  return *registry;
+}
+
+
+/** Takes a trace buffer for the thread when it first records an event, and gives it back when the thread exits. */
+class ThreadTraceBuffer
+{
+public:
+  ThreadTraceBuffer()
+  {
+    TraceRegistry & registry = get_trace_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    if (registry.free_buffers.empty())
+    {
+      registry.buffers.emplace_back(new TraceBuffer(registry.buffers.size()));
+      buffer = registry.buffers.back().get();
+    }
+    else
+    {
+      buffer = registry.free_buffers.back();
+      registry.free_buffers.pop_back();
+    }
+  }
+
+  ~ThreadTraceBuffer()
+  {
+    TraceRegistry & registry = get_trace_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.free_buffers.push_back(buffer);
+  }
+
+  ThreadTraceBuffer(ThreadTraceBuffer const &) = delete;
+  ThreadTraceBuffer & operator=(ThreadTraceBuffer const &) = delete;
+
+  TraceBuffer * buffer;
+};
+
+
+inline
+TraceBuffer &
+get_thread_trace_buffer()
+{
+  static thread_local ThreadTraceBuffer thread_buffer;
+  return *thread_buffer.buffer;
+}
+
+
+/** Returns the number of nanoseconds since the first time any thread asked for it. */
+std::uint64_t inline
+get_trace_time_ns()
+{
+  static std::chrono::steady_clock::time_point const epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+
+/** Writes the nanoseconds as microseconds, which is the unit of the trace format, without touching the stream flags. */
+void inline
+write_trace_microseconds(std::ostream & out, std::uint64_t const ns)
+{
+  char const fraction[4] = {static_cast<char>('0' + ns / 100 % 10),
+                            static_cast<char>('0' + ns / 10 % 10),
+                            static_cast<char>('0' + ns % 10),
+                            '\0'};
+  out << ns / 1000 << '.' << fraction;
+}
+
+
+void inline
+write_trace_string(std::ostream & out, char const * str)
+{
+  out << '"';
+
+  for (; *str != '\0'; ++str)
+  {
+    if (*str == '"' || *str == '\\')
+      out << '\\';
+
+    out << *str;
+  }
+
+  out << '"';
+}
+
+
+} // namespace stations_internal
+
+#endif // STATIONS_TRACE
+
+
+namespace stations
+{
+
+/**
+ * Records the time from its construction to its destruction as a slice of the calling thread. The name must outlive
+ * the trace, e.g. be a string literal.
+ */
+class TraceScope
+{
+public:
+  explicit TraceScope(char const * _name);
+  ~TraceScope();
+
+  TraceScope(TraceScope const &) = delete;
+  TraceScope & operator=(TraceScope const &) = delete;
+
+#ifdef STATIONS_TRACE
+private:
+  char const * name;
+  std::uint64_t start_ns;
+#endif
+};
+
+
+/** Records an event without a duration on the calling thread, e.g. when a task is added to a queue. */
+void trace_instant(char const * name);
+
+
+/**
+ * Writes the events of all threads in the Chrome Trace Event format, which chrome://tracing and Perfetto load. Each
+ * thread which has traced is a row, and stations reuse the rows of threads which have exited. Call it when no station
+ * is running, since a thread which is recording could overwrite an event while it is being written.
+ */
+void write_chrome_trace(std::ostream & out);
+
+
+/** Forgets every event recorded so far. Like write_chrome_trace, call it when no station is running. */
+void clear_trace();
+
+
+#ifdef STATIONS_TRACE
+
+/** A job which shows up as a slice with its own name in the trace. */
+template <typename TWork>
+class NamedWork
+{
+public:
+  NamedWork(char const * _name, TWork _work)
+    : name(_name)
+    , work(std::move(_work))
+  {}
+
+  template <typename ... Args>
+  auto
+  operator()(Args && ... args) -> decltype(std::declval<TWork &>()(std::forward<Args>(args) ...))
+  {
+    TraceScope scope(name);
+    return work(std::forward<Args>(args) ...);
+  }
+
+private:
+  char const * name;
+  TWork work;
+};
+
+
+/** Tags the work with a name, e.g. the phase of an algorithm, which is shown for it in the trace. Without tracing the
+ *  work is passed on unchanged.
+ */
+template <typename TWork>
+NamedWork<typename std::decay<TWork>::type> inline
+named(char const * name, TWork && work)
+{
+  return NamedWork<typename std::decay<TWork>::type>(name, std::forward<TWork>(work));
+}
+
+#else
+
+template <typename TWork>
+inline
+TWork &&
+named(char const *, TWork && work)
+{
+  return std::forward<TWork>(work);
+}
+
+#endif // STATIONS_TRACE
+
+
+} // namespace stations
+
+
+/* IMPLEMENTATION */
+
+
+namespace stations
+{
+
+#ifdef STATIONS_TRACE
+
+inline
+TraceScope::TraceScope(char const * _name)
+  : name(_name)
+  , start_ns(stations_internal::get_trace_time_ns())
+{}
+
+
+inline
+TraceScope::~TraceScope()
+{
+  stations_internal::TraceEvent event;
+  event.name = name;
+  event.start_ns = start_ns;
+  event.duration_ns = stations_internal::get_trace_time_ns() - start_ns;
+  event.is_instant = false;
+  stations_internal::get_thread_trace_buffer().record(event);
+}
+
+
+void inline
+trace_instant(char const * name)
+{
+  stations_internal::TraceEvent event;
+  event.name = name;
+  event.start_ns = stations_internal::get_trace_time_ns();
+  event.duration_ns = 0;
+  event.is_instant = true;
+  stations_internal::get_thread_trace_buffer().record(event);
+}
+
+
+void inline
+write_chrome_trace(std::ostream & out)
+{
+  stations_internal::TraceRegistry & registry = stations_internal::get_trace_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  bool is_first = true;
+  out << "{\"traceEvents\":[";
+
+  for (auto const & buffer : registry.buffers)
+  {
+    std::size_t const num_events = buffer->num_events.load(std::memory_order_acquire);
+    std::size_t const first_event =
+      num_events > STATIONS_TRACE_BUFFER_SIZE ? num_events - STATIONS_TRACE_BUFFER_SIZE : 0;
+
+    out << (is_first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->id
+        << ",\"args\":{\"name\":\"stations thread " << buffer->id << "\"}}";
+    is_first = false;
+
+    for (std::size_t e = first_event; e < num_events; ++e)
+    {
+      stations_internal::TraceEvent const & event = buffer->events[e % STATIONS_TRACE_BUFFER_SIZE];
+      out << ",\n{\"name\":";
+      stations_internal::write_trace_string(out, event.name);
+
+      if (event.is_instant)
+      {
+        out << ",\"ph\":\"i\",\"s\":\"t\"";
+      }
+      else
+      {
+        out << ",\"ph\":\"X\",\"dur\":";
+        stations_internal::write_trace_microseconds(out, event.duration_ns);
+      }
+
+      out << ",\"ts\":";
+      stations_internal::write_trace_microseconds(out, event.start_ns);
+      out << ",\"pid\":0,\"tid\":" << buffer->id << "}";
+    }
+  }
+
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+
+void inline
+clear_trace()
+{
+  stations_internal::TraceRegistry & registry = stations_internal::get_trace_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  for (auto const & buffer : registry.buffers)
+    buffer->num_events.store(0, std::memory_order_relaxed);
+}
+
+#else
+
+inline
+TraceScope::TraceScope(char const *)
+{}
+
+
+inline
+TraceScope::~TraceScope()
+{}
+
+
+void inline
+trace_instant(char const *)
+{}
+
+
+void inline
+write_chrome_trace(std::ostream & out)
+{
+  out << "{\"traceEvents\":[],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+
+void inline
+clear_trace()
+{}
+
+#endif // STATIONS_TRACE
+
+
+} // namespace stations
@@ -1,10 +1,53 @@
 #pragma once
 
 #include <atomic> // std::atomic
-#include <functional> // std::function
-#include <iostream> // std::cout, std::endl
-#include <thread> // std::this_thread::sleep_for
-#include <list> // std::list
+#include <chrono> // std::chrono::steady_clock
+#include <cstdint> // std::uint64_t
+#include <limits> // std::numeric_limits
+#include <memory> // std::unique_ptr
+#include <thread> // std::this_thread::yield
+#include <vector> // std::vector
+
+#include <stations/internal/ring_buffer.hpp> // stations_internal::RingBuffer
+#include <stations/internal/spin_wait.hpp> // stations_internal::cpu_relax, stations_internal::Sleeper
+
+#include <stations/arena.hpp> // stations::MonotonicArena, stations_internal::ArenaSwitch
+#include <stations/station_options.hpp> // stations::WAIT_STRATEGY
+#include <stations/station_stats.hpp> // stations::ThreadStats, stations_internal::ThreadCounters
+#include <stations/task.hpp> // stations::Task
+#include <stations/tracer.hpp> // stations::TraceScope, stations::trace_instant
+
+
+namespace stations_internal
+{
+
+using Clock = std::chrono::steady_clock;
+
+
+/** Returns the number of nanoseconds between the two time points. */
+std::uint64_t inline
+get_nanoseconds(Clock::time_point const from, Clock::time_point const to)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+
+/** A task in a worker queue, with the time it was added so the worker can tell how long it waited. */
+struct QueuedTask
+{
+  stations::Task task;
+  Clock::time_point enqueue_time;
+
+  QueuedTask() = default;
+
+  explicit QueuedTask(stations::Task && _task)
+    : task(std::move(_task))
+    , enqueue_time(Clock::now())
+  {}
+};
+
+
+} // namespace stations_internal
 
 
 namespace stations
@@ -13,20 +56,39 @@ namespace stations
 class WorkerQueue
 {
 public:
-  // Use std::list because pushing back to lists does not invalidate previous iterators
-  std::list<std::function<void()> > function_queue;
-  std::list<std::function<void()> >::iterator item_to_run;
-  bool finished = false;
-  std::atomic<std::size_t> queue_size;
-  std::size_t completed_items = 0;
+  // Fixed-capacity ring buffer, so the queue never allocates after construction
+  stations_internal::RingBuffer<stations_internal::QueuedTask> function_queue;
+  std::atomic<bool> finished;
+  std::atomic<std::size_t> queue_size; /** Number of items in queue, including the one which is running */
+  std::atomic<std::size_t> num_waiting; /** Number of items in queue which no worker has taken yet */
+  MonotonicArena arena; /** What the jobs run by this worker get from get_thread_arena() */
 
 
-  WorkerQueue();
-  void add_work_to_queue(std::function<void()> work);
+  WorkerQueue(std::size_t const max_queue_size = 2, WAIT_STRATEGY const wait_strategy = BALANCED);
+  bool add_work_to_queue(Task & work);
+  void finish();
+  void enable_work_stealing(std::vector<std::unique_ptr<WorkerQueue> > const & all_queues);
+  void notify_when_items_leave(stations_internal::Sleeper & sleeper);
   std::size_t get_number_of_items_in_queue() const;
   std::size_t get_number_of_completed_items() const;
+  ThreadStats get_stats() const;
   void operator()();
 
+private:
+  std::size_t spin_rounds; /** Number of empty polls with a CPU pause before starting to yield */
+  std::size_t yield_rounds; /** Number of empty polls with a yield before going to sleep */
+  stations_internal::Sleeper sleeper; /** Where the worker sleeps when there is no work */
+  stations_internal::Sleeper * leave_sleeper = nullptr; /** Notified when an item leaves the queue, if any */
+  std::vector<std::unique_ptr<WorkerQueue> > const * victims = nullptr; /** Queues to steal from, if any */
+  std::size_t next_victim = 0;
+  stations_internal::ThreadCounters counters; /** Stats of the worker, which only the worker thread writes */
+
+  void run(stations_internal::QueuedTask & item,
+           WorkerQueue & owner,
+           stations_internal::Clock::time_point & idle_since);
+  WorkerQueue * try_steal(stations_internal::QueuedTask & item);
+  void wait_for_work(std::size_t const idle_rounds);
+
 };
 
 } // namespace stations
@@ -40,21 +102,82 @@ namespace stations
 
 
 inline
-WorkerQueue::WorkerQueue()
+WorkerQueue::WorkerQueue(std::size_t const max_queue_size, WAIT_STRATEGY const wait_strategy)
+  : function_queue(max_queue_size)
+  , finished(false)
+  , queue_size(0)
+  , num_waiting(0)
+{
+  switch (wait_strategy)
+  {
+  case LOW_LATENCY:
+    spin_rounds = 4096;
+    yield_rounds = std::numeric_limits<std::size_t>::max();
+    break;
+
+  case POWER_SAVING:
+    spin_rounds = 16;
+    yield_rounds = 4;
+    break;
+
+  default: // BALANCED
+    spin_rounds = 512;
+    yield_rounds = 64;
+  }
+}
+
+
+/** Moves the work into the queue. Returns false, and leaves the work untouched, if the queue is full. */
+bool inline
+WorkerQueue::add_work_to_queue(Task & work)
+{
+  // Count the item before it is visible to the worker, otherwise the worker could decrement first
+  ++queue_size;
+  ++num_waiting;
+  stations_internal::QueuedTask item(std::move(work));
+
+  if (!function_queue.try_push(item))
+  {
+    work = std::move(item.task);
+    --num_waiting;
+    --queue_size;
+    trace_instant("queue full");
+    return false;
+  }
+
+  trace_instant("enqueue");
+
+  // The queue size was increased before notifying, so the worker cannot miss the new item
+  sleeper.notify_one();
+  return true;
+}
+
+
+void inline
+WorkerQueue::finish()
 {
-  queue_size = 0;
+  finished = true;
+  sleeper.notify_one();
 }
 
 
+/** Lets the worker take work from the other queues when its own queue is empty. All queues must outlive the worker
+ *  threads, and jobs in them must be safe to run on any worker.
+ */
 void inline
-WorkerQueue::add_work_to_queue(std::function<void()> work)
+WorkerQueue::enable_work_stealing(std::vector<std::unique_ptr<WorkerQueue> > const & all_queues)
 {
-  function_queue.push_back(work);
+  victims = &all_queues;
+}
 
-  if (queue_size == 0 && completed_items == 0)
-    item_to_run = function_queue.begin();
 
-  ++queue_size;
+/** Every thread sleeping in the sleeper will be notified every time a job from this queue has finished, e.g. so boss
+ *  threads can wait for room in the queue or for the work to finish.
+ */
+void inline
+WorkerQueue::notify_when_items_leave(stations_internal::Sleeper & _leave_sleeper)
+{
+  leave_sleeper = &_leave_sleeper;
 }
 
 
@@ -68,34 +191,140 @@ WorkerQueue::get_number_of_items_in_queue() const
 std::size_t inline
 WorkerQueue::get_number_of_completed_items() const
 {
-  return completed_items;
+  return counters.tasks_executed.load(std::memory_order_relaxed);
+}
+
+
+/** Returns the stats of the worker so far. Safe to call while the worker is running. */
+ThreadStats inline
+WorkerQueue::get_stats() const
+{
+  return counters.get_stats();
 }
 
 
 void inline
 WorkerQueue::operator()()
 {
+  stations_internal::ArenaSwitch arena_switch(arena);
+  stations_internal::QueuedTask item;
+  std::size_t idle_rounds = 0;
+  stations_internal::Clock::time_point idle_since = stations_internal::Clock::now();
+
   while (true)
   {
-    if (queue_size > 0)
-    {
-      if (completed_items != 0)
-        ++item_to_run;
+    // Read the flag before the queue, if it was set then every item has already been pushed
+    bool const is_finished = finished.load(std::memory_order_acquire);
+
+    WorkerQueue * victim;
 
-      (*item_to_run)();
-      ++completed_items;
-      --queue_size;
+    if (function_queue.try_pop(item))
+    {
+      --num_waiting;
+      run(item, *this, idle_since);
+      idle_rounds = 0;
+    }
+    else if ((victim = try_steal(item)) != nullptr)
+    {
+      run(item, *victim, idle_since);
+      idle_rounds = 0;
     }
-    else if (finished)
+    else if (is_finished)
     {
+      stations_internal::add_to_own_counter(
+        counters.idle_ns, stations_internal::get_nanoseconds(idle_since, stations_internal::Clock::now()));
       return;
     }
     else
     {
-      std::this_thread::sleep_for(std::chrono::microseconds(10));     // 0.01 ms
+      wait_for_work(idle_rounds++);
     }
   }
 }
 
 
+/** Runs work which was taken from the owner's queue. The work is counted in the owner's queue size until it has
+ *  finished, so the sum of all queue sizes never misses a job which is running. The time since the previous task
+ *  finished is counted as idle, and two clock reads give the time the task waited in the queue and ran.
+ */
+void inline
+WorkerQueue::run(stations_internal::QueuedTask & item,
+                 WorkerQueue & owner,
+                 stations_internal::Clock::time_point & idle_since)
+{
+  stations_internal::Clock::time_point const start = stations_internal::Clock::now();
+
+  {
+    TraceScope scope("task");
+    item.task();
+    item.task.reset();
+  }
+
+  stations_internal::Clock::time_point const end = stations_internal::Clock::now();
+
+  stations_internal::add_to_own_counter(counters.tasks_executed, static_cast<std::size_t>(1));
+  stations_internal::add_to_own_counter(counters.busy_ns, stations_internal::get_nanoseconds(start, end));
+  stations_internal::add_to_own_counter(counters.idle_ns, stations_internal::get_nanoseconds(idle_since, start));
+  stations_internal::add_to_own_counter(counters.queue_wait_ns,
+                                        stations_internal::get_nanoseconds(item.enqueue_time, start));
+  idle_since = end;
+  --owner.queue_size;
+
+  // Wake everyone, the sleeper is shared by threads waiting for room and threads waiting for all work to finish, and a
+  // single wake-up could go to one whose condition is still false
+  if (owner.leave_sleeper)
+    owner.leave_sleeper->notify_all();
+}
+
+
+/** Returns the queue the work was stolen from, or nullptr if there was nothing to steal. */
+inline
+WorkerQueue *
+WorkerQueue::try_steal(stations_internal::QueuedTask & item)
+{
+  if (victims == nullptr)
+    return nullptr;
+
+  std::size_t const num_queues = victims->size();
+
+  // Start where the last successful steal was, so thieves do not all pile onto the first queue
+  for (std::size_t i = 0; i < num_queues; ++i)
+  {
+    WorkerQueue & victim = *(*victims)[(next_victim + i) % num_queues];
+
+    if (&victim == this || victim.get_number_of_items_in_queue() == 0 || !victim.function_queue.try_pop(item))
+      continue;
+
+    --victim.num_waiting;
+    next_victim = (next_victim + i) % num_queues;
+    return &victim;
+  }
+
+  return nullptr;
+}
+
+
+void inline
+WorkerQueue::wait_for_work(std::size_t const idle_rounds)
+{
+  if (idle_rounds < spin_rounds)
+  {
+    stations_internal::cpu_relax();
+  }
+  else if (idle_rounds - spin_rounds < yield_rounds)
+  {
+    std::this_thread::yield();
+  }
+  else
+  {
+    stations_internal::Clock::time_point const start = stations_internal::Clock::now();
+    TraceScope scope("sleep");
+    // The queue size still counts a job a thief is running, so it would never let the owner sleep
+    sleeper.sleep_until([this]{return num_waiting > 0 || finished;});
+    stations_internal::add_to_own_counter(
+      counters.sleep_ns, stations_internal::get_nanoseconds(start, stations_internal::Clock::now()));
+  }
+}
+
+
 } // namespace stations
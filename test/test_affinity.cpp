@@ -0,0 +1,157 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::sort
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+#include <vector> // std::vector
+
+#if defined(__linux__)
+#include <sched.h> // sched_getcpu
+#endif
+
+#include <stations/internal/affinity.hpp> // stations_internal::parse_cpu_list
+
+#include <stations/algorithm.hpp> // stations::count, stations::first_touch_fill
+#include <stations/station.hpp> // stations::Station
+#include <stations/station_options.hpp> // stations::StationOptions
+
+
+/**************************
+ * Orders of CPUs to pick *
+ **************************/
+TEST_CASE("Parsing lists of CPUs")
+{
+  REQUIRE(stations_internal::parse_cpu_list("0-3,8,10-11\n") == std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+  REQUIRE(stations_internal::parse_cpu_list("5") == std::vector<int>({5}));
+  REQUIRE(stations_internal::parse_cpu_list("").empty());
+}
+
+
+TEST_CASE("Compact and scatter orders of CPUs")
+{
+  std::vector<std::vector<int> > const nodes = {{0, 1, 2}, {3, 4}};
+  REQUIRE(stations_internal::get_compact_cpu_order(nodes) == std::vector<int>({0, 1, 2, 3, 4}));
+  REQUIRE(stations_internal::get_scatter_cpu_order(nodes) == std::vector<int>({0, 3, 1, 4, 2}));
+}
+
+
+TEST_CASE("Every allowed CPU is on a NUMA node")
+{
+  std::vector<int> cpus = stations_internal::get_compact_cpu_order(stations_internal::get_numa_nodes());
+  std::sort(cpus.begin(), cpus.end());
+  REQUIRE(cpus == stations_internal::get_allowed_cpus());
+}
+
+
+/***************************
+ * Stations pinned to CPUs *
+ ***************************/
+void
+check_jobs_run(stations::StationOptions const & options)
+{
+  stations::Station station(options);
+  std::atomic<std::size_t> num_jobs(0);
+
+  for (int i = 0; i < 100; ++i)
+    station.add_work([&num_jobs]{++num_jobs;});
+
+  station.join();
+  REQUIRE(num_jobs == 100);
+}
+
+
+TEST_CASE("Stations with affinity options run their jobs")
+{
+  stations::StationOptions options;
+  options.set_num_threads(3);
+
+  SECTION("Compact")
+  {
+    options.affinity_mode = stations::COMPACT_AFFINITY;
+    check_jobs_run(options);
+  }
+
+  SECTION("Scatter")
+  {
+    options.affinity_mode = stations::SCATTER_AFFINITY;
+    check_jobs_run(options);
+  }
+
+  SECTION("Bound to the first NUMA node")
+  {
+    options.numa_node = 0;
+    check_jobs_run(options);
+  }
+
+  SECTION("CPUs which do not exist are ignored")
+  {
+    options.affinity_mode = stations::CPU_LIST_AFFINITY;
+    options.cpu_list = {-1};
+    check_jobs_run(options);
+  }
+}
+
+
+#if defined(__linux__)
+TEST_CASE("Workers run on the CPUs in the list")
+{
+  int const cpu = stations_internal::get_allowed_cpus().front();
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.affinity_mode = stations::CPU_LIST_AFFINITY;
+  options.cpu_list = {cpu};
+  stations::Station station(options);
+  std::atomic<int> num_elsewhere(0);
+
+  for (std::size_t t = 0; t < 2; ++t)
+    station.add_to_thread(t, [&num_elsewhere, cpu]{num_elsewhere += sched_getcpu() != cpu;});
+
+  station.join();
+  REQUIRE(num_elsewhere == 0);
+}
+
+
+namespace
+{
+
+/** Remembers the CPU of the thread which assigned it. */
+struct CpuOfWriter
+{
+  int cpu = -1;
+
+  CpuOfWriter() = default;
+  CpuOfWriter(CpuOfWriter const &) = default;
+
+  CpuOfWriter &
+  operator=(CpuOfWriter const &)
+  {
+    cpu = sched_getcpu();
+    return *this;
+  }
+};
+
+
+} // anonymous namespace
+
+
+TEST_CASE("First touch fill writes on workers with its own placement")
+{
+  int const cpu = stations_internal::get_allowed_cpus().front();
+  std::vector<int> ints(1000, 1);
+
+  // A pooled station with as many threads but without affinity must not be used by the fill
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  REQUIRE(stations::count(std::move(options), ints.begin(), ints.end(), 1) == 1000);
+
+  options.set_num_threads(3);
+  options.affinity_mode = stations::CPU_LIST_AFFINITY;
+  options.cpu_list = {cpu};
+  std::vector<CpuOfWriter> writers(300);
+  stations::first_touch_fill(std::move(options), writers.begin(), writers.end(), CpuOfWriter());
+
+  // The last partition is written by the boss, which is not pinned
+  for (std::size_t i = 0; i < 200; ++i)
+    REQUIRE(writers[i].cpu == cpu);
+}
+#endif
@@ -0,0 +1,122 @@
+#include <catch.hpp>
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uintptr_t
+#include <functional> // std::ref
+#include <set> // std::set
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <stations/arena.hpp> // stations::MonotonicArena, stations::ArenaAllocator, stations::get_thread_arena
+#include <stations/station.hpp> // stations::Station
+
+
+/********************
+ * Monotonic arenas *
+ ********************/
+TEST_CASE("Arenas hand out aligned memory and keep it after a release")
+{
+  stations::MonotonicArena arena(256 /*min_block_size*/);
+  char * first = static_cast<char *>(arena.allocate(1, 1));
+  void * aligned = arena.allocate(8, 64);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(aligned) % 64 == 0);
+
+  // Larger than a block
+  arena.allocate(1000);
+  std::size_t const capacity = arena.capacity();
+  REQUIRE(capacity >= 1256);
+
+  arena.release();
+  REQUIRE(arena.allocate(1, 1) == first);
+  arena.allocate(1000);
+  REQUIRE(arena.capacity() == capacity);
+}
+
+
+TEST_CASE("Arena scopes free their allocations")
+{
+  stations::MonotonicArena arena;
+  void * before = nullptr;
+
+  {
+    stations::ArenaScope scope(arena);
+    before = arena.allocate(100);
+  }
+
+  REQUIRE(arena.allocate(100) == before);
+}
+
+
+TEST_CASE("Containers can allocate from an arena")
+{
+  stations::MonotonicArena arena(64 /*min_block_size*/);
+  std::vector<int, stations::ArenaAllocator<int> > ints{stations::ArenaAllocator<int>(arena)};
+
+  for (int i = 0; i < 1000; ++i)
+    ints.push_back(i);
+
+  REQUIRE(ints.size() == 1000);
+  REQUIRE(ints[999] == 999);
+  REQUIRE(arena.capacity() >= 1000 * sizeof(int));
+}
+
+
+/**********************
+ * Arenas of the jobs *
+ **********************/
+TEST_CASE("Every thread of a station gives its jobs its own arena")
+{
+  stations::Station station(3 /*num_threads*/);
+  std::vector<stations::MonotonicArena *> arenas(300, nullptr);
+
+  for (std::size_t i = 0; i < arenas.size(); ++i)
+  {
+    station.add_work([&arenas](std::size_t const i)
+      {
+        arenas[i] = &stations::get_thread_arena();
+        arenas[i]->allocate(16);
+      }, i);
+  }
+
+  station.wait();
+
+  // The jobs the boss ran itself use the arena of the station, not the one of the calling thread
+  std::set<stations::MonotonicArena *> const distinct_arenas(arenas.begin(), arenas.end());
+  REQUIRE(distinct_arenas.size() <= 3);
+  REQUIRE(distinct_arenas.count(&stations::get_thread_arena()) == 0);
+
+  station.reset_arenas();
+  station.join();
+}
+
+
+TEST_CASE("Threads which add work to the same station run their jobs on their own boss arenas")
+{
+  // With one thread the boss runs every job itself
+  stations::Station station(1 /*num_threads*/);
+  std::vector<std::set<stations::MonotonicArena *> > arenas(2);
+
+  auto add_jobs = [&station](std::set<stations::MonotonicArena *> & thread_arenas)
+    {
+      for (int i = 0; i < 1000; ++i)
+      {
+        station.add_work([&thread_arenas]()
+          {
+            thread_arenas.insert(&stations::get_thread_arena());
+            static_cast<char *>(stations::get_thread_arena().allocate(64))[63] = 1;
+          });
+      }
+    };
+
+  std::thread first_boss(add_jobs, std::ref(arenas[0]));
+  std::thread second_boss(add_jobs, std::ref(arenas[1]));
+  first_boss.join();
+  second_boss.join();
+
+  REQUIRE(arenas[0].size() == 1);
+  REQUIRE(arenas[1].size() == 1);
+  REQUIRE(*arenas[0].begin() != *arenas[1].begin());
+
+  station.reset_arenas();
+  station.join();
+}
@@ -0,0 +1,95 @@
+#include <catch.hpp>
+
+#include <cstddef> // std::size_t
+#include <utility> // std::move
+#include <vector> // std::vector
+
+#include <stations/chunk_pool.hpp> // stations::ChunkPool, stations::PooledChunk
+#include <stations/pipeline.hpp> // stations::run_pipeline
+
+
+/***************
+ * Chunk pools *
+ ***************/
+TEST_CASE("Chunks are reserved and reused")
+{
+  stations::ChunkPool<int> pool(2 /*num_chunks*/, 100 /*chunk_size*/);
+  REQUIRE(pool.get_chunk_size() == 100);
+  int const * data = nullptr;
+
+  {
+    stations::PooledChunk<int> chunk = pool.acquire();
+    REQUIRE(chunk->empty());
+    REQUIRE(chunk->capacity() >= 100);
+    chunk->push_back(1);
+    data = chunk->data();
+  }
+
+  // Both chunks are free again, the one which came back last is handed out after the other one
+  stations::PooledChunk<int> first = pool.acquire();
+  stations::PooledChunk<int> second = pool.acquire();
+  REQUIRE(second->empty());
+  REQUIRE(second->data() == data);
+  REQUIRE(first->data() != data);
+}
+
+
+TEST_CASE("Moving and releasing chunks")
+{
+  stations::ChunkPool<int> pool(1 /*num_chunks*/, 10 /*chunk_size*/);
+  stations::PooledChunk<int> chunk;
+  REQUIRE(chunk->empty());
+
+  chunk = pool.acquire();
+  chunk->push_back(42);
+  stations::PooledChunk<int> moved(std::move(chunk));
+  REQUIRE((*moved)[0] == 42);
+
+  moved.release();
+  REQUIRE(moved->capacity() == 0);
+
+  // More chunks than the pool holds can be in use, the extra ones are freed when they come back
+  std::vector<stations::PooledChunk<int> > chunks;
+
+  for (int c = 0; c < 10; ++c)
+    chunks.push_back(pool.acquire());
+
+  for (auto & c : chunks)
+    REQUIRE(c->capacity() >= 10);
+}
+
+
+TEST_CASE("Chunks from a pool through a pipeline")
+{
+  stations::ChunkPool<int> pool(8 /*num_chunks*/, 64 /*chunk_size*/);
+  stations::StationOptions options;
+  options.set_num_threads(2);
+  int next = 0;
+  long sum = 0;
+
+  stations::run_pipeline<stations::PooledChunk<int> >(
+    std::move(options),
+    [&pool, &next](stations::PooledChunk<int> & chunk)
+    {
+      chunk = pool.acquire();
+
+      while (next < 10000 && chunk->size() < pool.get_chunk_size())
+        chunk->push_back(next++);
+
+      return !chunk->empty();
+    },
+    [](stations::PooledChunk<int> && chunk)
+    {
+      for (auto & i : *chunk)
+        i *= 2;
+
+      return std::move(chunk);
+    },
+    [&sum](stations::PooledChunk<int> && chunk)
+    {
+      for (int const i : *chunk)
+        sum += i;
+    });
+
+  REQUIRE(sum == 10000L * 9999L);
+}
@@ -70,3 +70,12 @@ TEST_CASE("Counting elements in a vector case 2")
   SECTION("Empty vector")
     check_int_count_case2<std::vector<int> >();
 }
+
+
+TEST_CASE("Counting with a value of another type")
+{
+  // The elements are compared with the value as it is, like std::count does, so no int equals 2.5
+  std::vector<int> const ints = {1, 2, 3, 2};
+  REQUIRE(stations::count(ints.begin(), ints.end(), 2.5) == 0);
+  REQUIRE(stations::count(ints.begin(), ints.end(), 2.0) == 2);
+}
@@ -2,9 +2,10 @@
 
 #include <deque> // std::deque
 #include <list> // std::list
+#include <memory> // std::unique_ptr
 #include <vector> // std::vector
 
-#include <stations/algorithm.hpp> // stations::all_of
+#include <stations/algorithm.hpp> // stations::fill, stations::first_touch_fill
 
 
 /***********************
@@ -46,3 +47,24 @@ TEST_CASE("Running fill with a small container")
   SECTION("Small vector")
     check_few_ints<std::vector<int> >();
 }
+
+
+/***************************
+ * Filling on every thread *
+ ***************************/
+TEST_CASE("First touch fill writes each partition on its own thread")
+{
+  for (std::size_t num_threads = 1; num_threads <= 5; num_threads += 2)
+  {
+    std::size_t const size = 1001;
+    std::unique_ptr<int[]> ints(new int[size]);
+    stations::StationOptions options;
+    options.set_num_threads(num_threads);
+    options.affinity_mode = stations::COMPACT_AFFINITY;
+    options.use_thread_pool = false;
+    stations::first_touch_fill(std::move(options), ints.get(), ints.get() + size, 7);
+
+    for (std::size_t i = 0; i < size; ++i)
+      REQUIRE(ints[i] == 7);
+  }
+}
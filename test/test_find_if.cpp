@@ -0,0 +1,127 @@
+#include <catch.hpp>
+
+#include <atomic> // std::atomic
+#include <deque> // std::deque
+#include <list> // std::list
+#include <vector> // std::vector
+
+#include <stations/algorithm.hpp> // stations::find, stations::find_if, stations::find_first_of
+#include <stations/cancellation_token.hpp> // stations::CancellationToken
+
+
+/***********************
+ * Cancellation tokens *
+ ***********************/
+TEST_CASE("Cancelling work after a position")
+{
+  stations::CancellationToken token;
+  REQUIRE(!token.is_cancelled());
+  REQUIRE(!token.is_cancelled(100));
+
+  token.cancel_from(5);
+  REQUIRE(!token.is_cancelled(4));
+  REQUIRE(token.is_cancelled(5));
+  REQUIRE(token.is_cancelled(100));
+
+  token.cancel_from(8); // Cancelling later positions does nothing
+  REQUIRE(!token.is_cancelled(4));
+
+  token.cancel();
+  REQUIRE(token.is_cancelled());
+}
+
+
+/**********************************
+ * Finding elements in containers *
+ **********************************/
+template <typename T>
+void
+check_find_if(std::size_t const num_threads, std::size_t const chunk_size)
+{
+  T ints(10000, 0);
+  auto it = ints.begin();
+  std::advance(it, 7000);
+  *it = 1;
+  std::advance(it, 2000);
+  *it = 1;
+
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  auto found = stations::find_if(std::move(options), ints.begin(), ints.end(), [](int i){return i == 1;});
+  REQUIRE(std::distance(ints.begin(), found) == 7000);
+
+  REQUIRE(stations::find_if(ints.begin(), ints.end(), [](int i){return i == 2;}) == ints.end());
+}
+
+
+TEST_CASE("Finding the first element using find_if")
+{
+  SECTION("Empty vector")
+  {
+    std::vector<int> ints;
+    REQUIRE(stations::find_if(ints.begin(), ints.end(), [](int){return true;}) == ints.end());
+  }
+
+  SECTION("Vector split evenly")
+    check_find_if<std::vector<int> >(3, 0);
+
+  SECTION("Vector in small chunks")
+    check_find_if<std::vector<int> >(4, 100);
+
+  SECTION("List in chunks")
+    check_find_if<std::list<int> >(2, 1000);
+
+  SECTION("Deque in chunks")
+    check_find_if<std::deque<int> >(3, 1500);
+
+  SECTION("Lowest match when every partition has a match")
+  {
+    std::vector<int> ints(10000, 1);
+    ints[0] = 0;
+    stations::StationOptions options;
+    options.set_num_threads(4);
+    options.chunk_size = 10;
+    REQUIRE(stations::find_if(std::move(options), ints.begin(), ints.end(), [](int i){return i == 1;}) ==
+            ints.begin() + 1);
+  }
+}
+
+
+TEST_CASE("Finding the first of some elements using find_first_of")
+{
+  std::vector<int> ints = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+  std::vector<int> const needles = {3, 5};
+
+  REQUIRE(stations::find_first_of(ints.begin(), ints.end(), needles.begin(), needles.end()) == ints.begin() + 4);
+  REQUIRE(stations::find_first_of(ints.begin(), ints.end(), needles.begin(), needles.end(),
+                                  [](int a, int b){return a == b + 1;}) == ints.begin() + 3);
+  REQUIRE(stations::find_first_of(ints.begin(), ints.end(), needles.begin(), needles.begin()) == ints.end());
+}
+
+
+/***********************
+ * Stopping jobs early *
+ ***********************/
+TEST_CASE("Running jobs stop once the answer is known")
+{
+  std::size_t const N = 1000000;
+  std::vector<int> ints(N, 0);
+  ints[10] = 1;
+  std::atomic<std::size_t> num_calls(0);
+  auto is_one = [&num_calls](int i){++num_calls; return i == 1;};
+
+  stations::StationOptions options;
+  options.set_num_threads(2);
+  options.chunk_size = N / 2; // Without the cancellation token, both chunks would be checked in full
+  REQUIRE(stations::any_of(std::move(options), ints.begin(), ints.end(), is_one));
+  REQUIRE(num_calls < N);
+}
+
+
+TEST_CASE("Finding the first element equal to a value using find")
+{
+  std::vector<int> ints = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 5};
+  REQUIRE(stations::find(ints.begin(), ints.end(), 5) == ints.begin() + 4);
+  REQUIRE(stations::find(ints.begin(), ints.end(), 10) == ints.end());
+}
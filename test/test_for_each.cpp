@@ -1,11 +1,12 @@
 #include <catch.hpp>
 
+#include <algorithm> // std::count
 #include <deque> // std::deque
 #include <list> // std::list
 #include <mutex> // std::mutex
 #include <vector> // std::vector
 
-#include <stations/algorithm.hpp> // stations::count
+#include <stations/algorithm.hpp> // stations::for_each, stations::for_each_n
 
 /********************************
  * For each in empty containers *
@@ -59,3 +60,52 @@ TEST_CASE("Check if for_each work in for a small set of integers")
   SECTION("Deque")
     check_non_empty_ints<std::deque<int> >();
 }
+
+
+/*********************************
+ * For each visits every element *
+ *********************************/
+template<typename T>
+void
+check_every_element_is_visited(std::size_t const chunk_size)
+{
+  T ints(10000, 1);
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.chunk_size = chunk_size;
+  stations::for_each(std::move(options), ints.begin(), ints.end(), [](int & i){i *= 2;});
+  REQUIRE(std::count(ints.begin(), ints.end(), 2) == 10000);
+}
+
+
+TEST_CASE("Check if for_each visits every element of each chunk")
+{
+  SECTION("Vector partitioned evenly")
+    check_every_element_is_visited<std::vector<int> >(0);
+
+  SECTION("Vector in chunks")
+    check_every_element_is_visited<std::vector<int> >(7);
+
+  SECTION("List in chunks")
+    check_every_element_is_visited<std::list<int> >(100);
+
+  SECTION("Deque in chunks")
+    check_every_element_is_visited<std::deque<int> >(1000);
+
+  SECTION("Vector with the default grain size")
+  {
+    std::vector<int> ints(100000, 1);
+    stations::for_each(ints.begin(), ints.end(), [](int & i){i *= 2;});
+    REQUIRE(std::count(ints.begin(), ints.end(), 2) == 100000);
+  }
+}
+
+
+TEST_CASE("Check if for_each_n visits the first n elements")
+{
+  std::vector<int> ints(10000, 1);
+  auto it = stations::for_each_n(ints.begin(), 6000, [](int & i){i = 0;});
+  REQUIRE(it == ints.begin() + 6000);
+  REQUIRE(std::count(ints.begin(), ints.end(), 0) == 6000);
+  REQUIRE(std::count(ints.begin() + 6000, ints.end(), 1) == 4000);
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+
+#include <atomic> // std::atomic
+#include <memory> // std::unique_ptr
+#include <string> // std::string
+#include <thread> // std::this_thread::yield
+#include <vector> // std::vector
+
+#include <stations/future.hpp> // stations::Future, stations::ResultSlot
+#include <stations/station.hpp> // stations::Station
+#include <stations/thread_pool.hpp> // stations::PooledStation
+
+
+/****************
+ * Result slots *
+ ****************/
+TEST_CASE("Result slots hold one result at a time")
+{
+  stations::ResultSlot<std::string> slot;
+  REQUIRE(!slot.is_ready());
+
+  slot.set(3, 'a');
+  REQUIRE(slot.is_ready());
+  REQUIRE(slot.get() == "aaa");
+
+  slot.reset();
+  REQUIRE(!slot.is_ready());
+
+  slot.set("reused");
+  REQUIRE(slot.get() == "reused");
+}
+
+
+/****************************
+ * Futures from adding work *
+ ***************************/
+TEST_CASE("Getting results of work through futures")
+{
+  SECTION("Without worker threads the work runs before add_work_with_result returns")
+  {
+    stations::Station station(1 /*num_threads*/);
+    stations::ResultSlot<int> slot;
+    stations::Future<int> future = station.add_work_with_result(slot, [](int a, int b){return a + b;}, 2, 3);
+    REQUIRE(future.is_ready());
+    REQUIRE(future.get() == 5);
+  }
+
+  SECTION("Move-only results")
+  {
+    stations::Station station(3 /*num_threads*/);
+    std::vector<stations::ResultSlot<std::unique_ptr<int> > > slots(100);
+    std::vector<stations::Future<std::unique_ptr<int> > > futures;
+
+    for (int i = 0; i < 100; ++i)
+      futures.push_back(station.add_work_with_result(slots[i], [](int n){return std::unique_ptr<int>(new int(n));}, i));
+
+    for (int i = 0; i < 100; ++i)
+      REQUIRE(*futures[i].get() == i);
+
+    station.join();
+  }
+
+  SECTION("A result can be read while other work is still running")
+  {
+    stations::Station station(3 /*num_threads*/);
+    std::atomic<bool> release(false);
+    stations::ResultSlot<int> slow_slot;
+    stations::ResultSlot<int> fast_slot;
+
+    station.add_work_with_result(slow_slot, [&release]
+      {
+        while (!release)
+          std::this_thread::yield();
+
+        return 1;
+      });
+
+    stations::Future<int> fast = station.add_work_with_result(fast_slot, []{return 2;});
+    REQUIRE(fast.get() == 2);
+    REQUIRE(!slow_slot.is_ready());
+
+    release = true;
+    REQUIRE(slow_slot.get() == 1);
+    station.join();
+  }
+
+  SECTION("Pooled stations")
+  {
+    stations::StationOptions options;
+    options.set_num_threads(2);
+    stations::PooledStation station(options);
+    stations::ResultSlot<long> slot;
+    REQUIRE(station.add_work_with_result(slot, [](long n){return n * 2;}, 21).get() == 42);
+    station.join();
+  }
+}
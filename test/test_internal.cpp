@@ -1,5 +1,8 @@
 #include <catch.hpp>
 
+#include <functional> // std::less
+#include <vector> // std::vector
+
 #include <stations/internal/algorithm_help_functions.hpp> // stations_internal::get_random_ints
 
 
@@ -19,3 +22,24 @@ TEST_CASE("highest_ordered_bit function")
   REQUIRE(stations_internal::highest_ordered_bit(8) == 8);
   REQUIRE(stations_internal::highest_ordered_bit(65) == 64);
 }
+
+
+/*****************************
+ * merge_path_split function *
+ *****************************/
+TEST_CASE("merge_path_split function")
+{
+  std::vector<int> const a = {1, 3, 5, 7};
+  std::vector<int> const b = {2, 3, 4};
+  std::less<int> const comp;
+
+  // The merged sequence is 1(a) 2(b) 3(a) 3(b) 4(b) 5(a) 7(a), ties are taken from `a` first
+  std::vector<std::size_t> const expected = {0, 1, 1, 2, 2, 2, 3, 4};
+
+  for (std::size_t d = 0; d < expected.size(); ++d)
+    REQUIRE(stations_internal::merge_path_split(a.begin(), a.size(), b.begin(), b.size(), d, comp) == expected[d]);
+
+  // Merging with an empty range
+  REQUIRE(stations_internal::merge_path_split(a.begin(), a.size(), b.begin(), 0, 3, comp) == 3);
+  REQUIRE(stations_internal::merge_path_split(a.begin(), 0, b.begin(), b.size(), 2, comp) == 0);
+}
@@ -0,0 +1,84 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::min_element, std::max_element, std::minmax_element
+#include <deque> // std::deque
+#include <list> // std::list
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+
+#include <stations/algorithm.hpp> // stations::min_element, stations::max_element, stations::minmax_element
+
+
+/****************************************
+ * Extreme elements of empty containers *
+ ***************************************/
+TEST_CASE("Finding extreme elements of an empty container")
+{
+  std::vector<int> ints;
+  REQUIRE(stations::min_element(ints.begin(), ints.end()) == ints.end());
+  REQUIRE(stations::max_element(ints.begin(), ints.end()) == ints.end());
+  REQUIRE(stations::minmax_element(ints.begin(), ints.end()).first == ints.end());
+  REQUIRE(stations::minmax_element(ints.begin(), ints.end()).second == ints.end());
+}
+
+
+/************************************
+ * Extreme elements compared to std *
+ ***********************************/
+template <typename T>
+void
+check_extreme_elements(std::size_t const num_threads, std::size_t const chunk_size)
+{
+  // Few distinct values, so there are many ties
+  std::vector<int> random_ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+
+  for (auto & i : random_ints)
+    i %= 50;
+
+  T ints(random_ints.begin(), random_ints.end());
+
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  REQUIRE(stations::min_element(std::move(options), ints.begin(), ints.end(), std::less<int>()) ==
+          std::min_element(ints.begin(), ints.end()));
+
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  REQUIRE(stations::max_element(std::move(options), ints.begin(), ints.end(), std::less<int>()) ==
+          std::max_element(ints.begin(), ints.end()));
+
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  REQUIRE(stations::minmax_element(std::move(options), ints.begin(), ints.end(), std::less<int>()) ==
+          std::minmax_element(ints.begin(), ints.end()));
+}
+
+
+TEST_CASE("Finding extreme elements gives the same elements as std")
+{
+  SECTION("Vector with one thread")
+    check_extreme_elements<std::vector<int> >(1, 0);
+
+  SECTION("Vector split evenly")
+    check_extreme_elements<std::vector<int> >(3, 0);
+
+  SECTION("Vector in chunks")
+    check_extreme_elements<std::vector<int> >(4, 333);
+
+  SECTION("List split evenly")
+    check_extreme_elements<std::list<int> >(3, 0);
+
+  SECTION("Deque in chunks")
+    check_extreme_elements<std::deque<int> >(2, 1000);
+
+  SECTION("More threads than elements")
+  {
+    std::vector<int> ints = {3, 1, 2};
+    stations::StationOptions options;
+    options.set_num_threads(8);
+    REQUIRE(stations::min_element(std::move(options), ints.begin(), ints.end(), std::less<int>()) ==
+            ints.begin() + 1);
+  }
+}
@@ -93,3 +93,87 @@ TEST_CASE("Get split iterators for some vector")
     REQUIRE(split_iters.back() == ints.end());
   }
 }
+
+
+/********************************
+ * Partitioning in fixed chunks *
+ *******************************/
+template <typename T>
+void
+check_chunk_iterators(std::size_t const chunk_size)
+{
+  T ints(10, 0);
+  stations::StationOptions options;
+  options.chunk_size = chunk_size;
+  std::vector<typename T::iterator> split_iters = stations::get_partition_iterators(ints.begin(), ints.end(), options);
+  REQUIRE(split_iters.size() == (10 + chunk_size - 1) / chunk_size + 1);
+  REQUIRE(split_iters.capacity() >= split_iters.size());
+
+  for (std::size_t i = 0; i < split_iters.size() - 1; ++i)
+    REQUIRE(static_cast<std::size_t>(std::distance(ints.begin(), split_iters[i])) == i * chunk_size);
+
+  REQUIRE(split_iters.back() == ints.end());
+}
+
+
+TEST_CASE("Get chunk iterators")
+{
+  SECTION("Vector with chunks of 1")
+    check_chunk_iterators<std::vector<int> >(1);
+
+  SECTION("Vector with chunks of 3")
+    check_chunk_iterators<std::vector<int> >(3);
+
+  SECTION("Vector with a chunk larger than the vector")
+    check_chunk_iterators<std::vector<int> >(20);
+
+  SECTION("List with chunks of 3")
+    check_chunk_iterators<std::list<int> >(3);
+
+  SECTION("Deque with chunks of 5")
+    check_chunk_iterators<std::deque<int> >(5);
+}
+
+
+/************************
+ * Lazy partition views *
+ ***********************/
+template <typename T>
+void
+check_partition_view(std::size_t const num_threads, std::size_t const chunk_size)
+{
+  T ints(11, 0);
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  std::vector<typename T::iterator> split_iters = stations::get_partition_iterators(ints.begin(), ints.end(), options);
+  stations::PartitionView<typename T::iterator> partitions =
+    stations::get_partition_view(ints.begin(), ints.end(), options);
+
+  REQUIRE(partitions.num_partitions() == split_iters.size() - 1);
+
+  for (std::size_t i = 0; i < partitions.num_partitions(); ++i)
+  {
+    REQUIRE(partitions.partition_first(i) == split_iters[i]);
+    REQUIRE(partitions.partition_last(i) == split_iters[i + 1]);
+  }
+}
+
+
+TEST_CASE("Partition views match the partition iterators")
+{
+  SECTION("Vector split evenly")
+    check_partition_view<std::vector<int> >(3, 0);
+
+  SECTION("Vector split into more parts than elements")
+    check_partition_view<std::vector<int> >(16, 0);
+
+  SECTION("Vector in chunks")
+    check_partition_view<std::vector<int> >(3, 4);
+
+  SECTION("List split evenly")
+    check_partition_view<std::list<int> >(3, 0);
+
+  SECTION("List in chunks")
+    check_partition_view<std::list<int> >(3, 4);
+}
@@ -0,0 +1,173 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::max, std::remove_if, std::sort
+#include <cstddef> // std::size_t
+#include <numeric> // std::accumulate
+#include <thread> // std::thread, std::this_thread::get_id, std::this_thread::yield
+#include <vector> // std::vector
+
+#include <stations/pipeline.hpp> // stations::run_pipeline, stations::chain_stages
+
+
+namespace
+{
+
+/** Returns a source which produces the numbers 0 to num_items - 1. */
+struct CountingSource
+{
+  int next;
+  int num_items;
+
+  bool
+  operator()(int & item)
+  {
+    if (next == num_items)
+      return false;
+
+    item = next++;
+    return true;
+  }
+};
+
+
+stations::StationOptions
+get_options(std::size_t const num_threads)
+{
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.use_thread_pool = false;
+  return options;
+}
+
+
+} // anonymous namespace
+
+
+/**************************
+ * Pipelines of one stage *
+ **************************/
+TEST_CASE("Pipelines preserve the order of the items")
+{
+  for (std::size_t num_threads = 1; num_threads <= 4; num_threads *= 2)
+  {
+    std::vector<int> results;
+    std::size_t const num_items =
+      stations::run_pipeline<int>(get_options(num_threads), CountingSource{0, 1000},
+                                  [](int i){
+                                    // Make the early items slower, so they finish out of order
+                                    for (int y = 0; y < (1000 - i) % 7; ++y)
+                                      std::this_thread::yield();
+
+                                    return 2 * i;
+                                  },
+                                  [&results](int i){results.push_back(i);});
+
+    REQUIRE(num_items == 1000);
+    REQUIRE(results.size() == 1000);
+
+    for (int i = 0; i < 1000; ++i)
+      REQUIRE(results[i] == 2 * i);
+  }
+}
+
+
+TEST_CASE("Pipelines can hand results to the sink in any order")
+{
+  std::vector<int> results;
+  stations::run_pipeline<int>(get_options(3), CountingSource{0, 1000}, [](int i){return i;},
+                              [&results](int i){results.push_back(i);}, stations::ANY_ORDER);
+
+  std::sort(results.begin(), results.end());
+  REQUIRE(results.size() == 1000);
+
+  for (int i = 0; i < 1000; ++i)
+    REQUIRE(results[i] == i);
+}
+
+
+TEST_CASE("A pipeline with an empty source never calls the sink")
+{
+  int num_sunk = 0;
+  REQUIRE(stations::run_pipeline<int>(get_options(2), CountingSource{0, 0}, [](int i){return i;},
+                                      [&num_sunk](int){++num_sunk;}) == 0);
+  REQUIRE(num_sunk == 0);
+}
+
+
+/**************************************
+ * Pipelines of chunks through stages *
+ **************************************/
+TEST_CASE("Chained stages filter and transform chunks")
+{
+  int next = 0;
+  auto read_chunk = [&next](std::vector<int> & chunk)
+    {
+      if (next == 10000)
+        return false;
+
+      for (int i = 0; i < 100; ++i)
+        chunk.push_back(next++);
+
+      return true;
+    };
+
+  auto keep_even = [](std::vector<int> && chunk)
+    {
+      chunk.erase(std::remove_if(chunk.begin(), chunk.end(), [](int i){return i % 2 != 0;}), chunk.end());
+      return std::move(chunk);
+    };
+
+  auto sum = [](std::vector<int> && chunk){return std::accumulate(chunk.begin(), chunk.end(), 0L);};
+  std::vector<long> sums;
+
+  stations::run_pipeline<std::vector<int> >(get_options(4), read_chunk, stations::chain_stages(keep_even, sum),
+                                            [&sums](long s){sums.push_back(s);});
+
+  REQUIRE(sums.size() == 100);
+
+  // The even numbers of chunk c are 100 * c, 100 * c + 2, ..., 100 * c + 98
+  for (long c = 0; c < 100; ++c)
+    REQUIRE(sums[c] == 50 * 100 * c + 2450);
+}
+
+
+TEST_CASE("The source waits for the sink when the pipeline is full")
+{
+  stations::StationOptions options = get_options(2);
+  options.max_queue_size = 3;
+  std::size_t const max_items_in_flight = (options.num_threads - 1) * options.max_queue_size;
+  std::size_t num_read = 0;
+  std::size_t num_sunk = 0;
+  std::size_t most_in_flight = 0;
+
+  stations::run_pipeline<int>(std::move(options),
+                              [&](int & item){
+                                most_in_flight = std::max(most_in_flight, ++num_read - num_sunk);
+                                item = static_cast<int>(num_read);
+                                return num_read <= 500;
+                              },
+                              [](int i){return i;},
+                              [&num_sunk](int){++num_sunk;});
+
+  REQUIRE(num_sunk == 500);
+  REQUIRE(most_in_flight <= max_items_in_flight + 1);
+}
+
+
+TEST_CASE("The calling thread never runs a stage when there are workers")
+{
+  for (std::size_t num_threads = 2; num_threads <= 4; ++num_threads)
+  {
+    std::vector<std::thread::id> stage_threads(2000);
+
+    stations::run_pipeline<int>(get_options(num_threads), CountingSource{0, 2000},
+                                [&stage_threads](int i){
+                                  stage_threads[i] = std::this_thread::get_id();
+                                  return i;
+                                },
+                                [](int){});
+
+    for (std::thread::id const & stage_thread : stage_threads)
+      REQUIRE(stage_thread != std::this_thread::get_id());
+  }
+}
@@ -0,0 +1,167 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::is_sorted, std::stable_sort
+#include <cstdint> // std::int8_t, std::uint64_t
+#include <limits> // std::numeric_limits
+#include <string> // std::string, std::to_string
+#include <utility> // std::move
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+
+#include <stations/radix_sort.hpp> // stations::radix_sort
+
+
+/**************
+ * Radix keys *
+ **************/
+TEST_CASE("Radix keys keep the order of the values")
+{
+  std::vector<int> const ints = {std::numeric_limits<int>::min(), -100, -1, 0, 1, 100, std::numeric_limits<int>::max()};
+
+  for (std::size_t i = 1; i < ints.size(); ++i)
+    REQUIRE(stations_internal::to_radix_key(ints[i - 1]) < stations_internal::to_radix_key(ints[i]));
+
+  std::vector<double> const doubles = {-std::numeric_limits<double>::infinity(), -1e10, -1.5, -1e-10, 0.0, 1e-10, 1.5,
+                                       1e10, std::numeric_limits<double>::infinity()};
+
+  for (std::size_t i = 1; i < doubles.size(); ++i)
+    REQUIRE(stations_internal::to_radix_key(doubles[i - 1]) < stations_internal::to_radix_key(doubles[i]));
+}
+
+
+/*******************
+ * Radix sort data *
+ *******************/
+template <typename T>
+void
+check_radix_sort(std::vector<T> values, std::size_t const num_threads)
+{
+  std::vector<T> expected_values = values;
+  std::sort(expected_values.begin(), expected_values.end());
+
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  stations::radix_sort(std::move(options), values.begin(), values.end());
+  REQUIRE(values == expected_values);
+}
+
+
+TEST_CASE("Radix sorting numbers")
+{
+  std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(100000);
+
+  SECTION("Empty vector")
+    check_radix_sort(std::vector<int>(), 2);
+
+  SECTION("Ints with one thread")
+    check_radix_sort(ints, 1);
+
+  SECTION("Ints with three threads")
+    check_radix_sort(ints, 3);
+
+  SECTION("Small ints, where most passes are skipped")
+  {
+    std::vector<int> small_ints(ints.begin(), ints.end());
+
+    for (auto & i : small_ints)
+      i %= 100;
+
+    check_radix_sort(small_ints, 4);
+  }
+
+  SECTION("Bytes")
+  {
+    std::vector<std::int8_t> bytes(ints.begin(), ints.begin() + 1000);
+    check_radix_sort(bytes, 2);
+  }
+
+  SECTION("Unsigned 64-bit integers")
+  {
+    std::vector<std::uint64_t> uints;
+
+    for (int const i : ints)
+      uints.push_back(static_cast<std::uint64_t>(i) * 2654435761u);
+
+    check_radix_sort(uints, 4);
+  }
+
+  SECTION("Floats")
+  {
+    std::vector<float> floats;
+
+    for (int const i : ints)
+      floats.push_back(static_cast<float>(i) / 1000.0f);
+
+    check_radix_sort(floats, 3);
+  }
+}
+
+
+/***********************
+ * Radix sort with key *
+ **********************/
+struct Record
+{
+  long key;
+  int original_position;
+};
+
+
+TEST_CASE("Radix sorting structs by a key is stable")
+{
+  std::vector<Record> records;
+
+  for (int i = 0; i < 10000; ++i)
+    records.push_back({(i * 7919) % 101 - 50, i});
+
+  std::vector<Record> expected_records = records;
+  std::stable_sort(expected_records.begin(), expected_records.end(),
+                   [](Record const & a, Record const & b){return a.key < b.key;});
+
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  stations::radix_sort(std::move(options), records.begin(), records.end(), [](Record const & r){return r.key;});
+
+  for (std::size_t i = 0; i < records.size(); ++i)
+  {
+    REQUIRE(records[i].key == expected_records[i].key);
+    REQUIRE(records[i].original_position == expected_records[i].original_position);
+  }
+}
+
+
+/** A record which cannot be default constructed and owns memory, so the buffers must construct and destroy it. */
+struct NamedRecord
+{
+  NamedRecord(int const _key, std::string _name)
+    : key(_key)
+    , name(std::move(_name))
+  {}
+
+  int key;
+  std::string name;
+};
+
+
+TEST_CASE("Radix sorting structs without a default constructor")
+{
+  std::vector<NamedRecord> records;
+
+  for (int i = 0; i < 10000; ++i)
+    records.push_back(NamedRecord((i * 7919) % 1009 - 500, std::to_string(i)));
+
+  std::vector<NamedRecord> expected_records = records;
+  std::stable_sort(expected_records.begin(), expected_records.end(),
+                   [](NamedRecord const & a, NamedRecord const & b){return a.key < b.key;});
+
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  stations::radix_sort(std::move(options), records.begin(), records.end(), [](NamedRecord const & r){return r.key;});
+
+  for (std::size_t i = 0; i < records.size(); ++i)
+  {
+    REQUIRE(records[i].key == expected_records[i].key);
+    REQUIRE(records[i].name == expected_records[i].name);
+  }
+}
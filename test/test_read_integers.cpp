@@ -0,0 +1,161 @@
+#include <catch.hpp>
+
+#include <climits> // INT_MAX, INT_MIN
+#include <cstddef> // std::size_t
+#include <cstdio> // std::remove
+#include <fstream> // std::ofstream
+#include <string> // std::string, std::to_string
+#include <vector> // std::vector
+
+#include <stations/station_options.hpp> // stations::StationOptions
+
+#include "../examples/read_integers_from_file.hpp" // stations::parse_integers, stations::ReadIntegersFromFile
+
+
+namespace
+{
+
+/** A file with the given contents, which is removed again when it goes out of scope. */
+class TemporaryFile
+{
+public:
+  explicit TemporaryFile(std::string const & contents)
+    : file_name("test_read_integers.txt")
+  {
+    std::ofstream file(file_name, std::ios::binary);
+    file << contents;
+  }
+
+  ~TemporaryFile()
+  {
+    std::remove(file_name.c_str());
+  }
+
+  std::string const file_name;
+};
+
+
+std::vector<int>
+read_all(stations::ReadIntegersFromFile & riff)
+{
+  std::vector<int> integers;
+  std::vector<int> chunk;
+
+  while (riff(chunk))
+    integers.insert(integers.end(), chunk.begin(), chunk.end());
+
+  return integers;
+}
+
+
+std::vector<int>
+parse_all(std::string const & text)
+{
+  std::vector<int> integers;
+  char const * last = text.data() + text.size();
+  stations::parse_integers(text.data(), last, last, true /*is_end_of_file*/, integers, text.size());
+  return integers;
+}
+
+
+} // anonymous namespace
+
+
+/*******************
+ * Parsing a block *
+ *******************/
+TEST_CASE("Parsing integers")
+{
+  SECTION("Negative numbers and the limits of int")
+    REQUIRE(parse_all("-5\n0\n-2147483648\n2147483647\n") == std::vector<int>({-5, 0, INT_MIN, INT_MAX}));
+
+  SECTION("CRLF line endings")
+    REQUIRE(parse_all("1\r\n-22\r\n333\r\n") == std::vector<int>({1, -22, 333}));
+
+  SECTION("A missing final newline")
+    REQUIRE(parse_all("1\n2\n3") == std::vector<int>({1, 2, 3}));
+
+  SECTION("Lines without digits are skipped")
+    REQUIRE(parse_all("1\n\n-\nx\n2\n") == std::vector<int>({1, 2}));
+
+  SECTION("The last line waits for more bytes unless it is the end of the file")
+  {
+    std::string const text = "12\n34";
+    std::vector<int> integers;
+    char const * last = text.data() + text.size();
+    char const * rest = stations::parse_integers(text.data(), last, last, false /*is_end_of_file*/, integers, 10);
+    REQUIRE(integers == std::vector<int>({12}));
+    REQUIRE(std::string(rest, last) == "34");
+  }
+}
+
+
+/*********************
+ * Reading from file *
+ *********************/
+TEST_CASE("Reading integers from a file")
+{
+  SECTION("CRLF line endings and a missing final newline")
+  {
+    TemporaryFile file("7\r\n-8\r\n9");
+    stations::ReadIntegersFromFile riff(file.file_name);
+    REQUIRE(read_all(riff) == std::vector<int>({7, -8, 9}));
+  }
+
+  SECTION("A line which crosses the end of a block")
+  {
+    // Blank lines are skipped, so they move the number onto the boundary of the first block of 1 MiB
+    std::string const contents = std::string((1 << 20) - 3, '\n') + "-123456\n42";
+    TemporaryFile file(contents);
+    stations::ReadIntegersFromFile riff(file.file_name);
+    riff.set_chunk_size(1);
+    REQUIRE(read_all(riff) == std::vector<int>({-123456, 42}));
+  }
+
+  SECTION("A line longer than a block ends the reading")
+  {
+    TemporaryFile file("1\n" + std::string(1 << 20, ' ') + "\n2\n");
+    stations::ReadIntegersFromFile riff(file.file_name);
+    REQUIRE(read_all(riff) == std::vector<int>({1}));
+  }
+}
+
+
+TEST_CASE("Reading a file in byte ranges")
+{
+  std::string contents;
+  std::vector<int> expected;
+
+  for (int i = -50; i < 50; ++i)
+  {
+    contents += std::to_string(i * 1009) + (i % 3 == 0 ? "\r\n" : "\n");
+    expected.push_back(i * 1009);
+  }
+
+  contents += "77"; // No final newline
+  expected.push_back(77);
+  TemporaryFile file(contents);
+
+  SECTION("Two readers split at every byte")
+  {
+    for (std::size_t split = 0; split <= contents.size(); ++split)
+    {
+      stations::ReadIntegersFromFile first_riff(file.file_name, 0, split);
+      stations::ReadIntegersFromFile second_riff(file.file_name, split, contents.size());
+      std::vector<int> integers = read_all(first_riff);
+      std::vector<int> const second_integers = read_all(second_riff);
+      integers.insert(integers.end(), second_integers.begin(), second_integers.end());
+      REQUIRE(integers == expected);
+    }
+  }
+
+  SECTION("Any number of readers in parallel")
+  {
+    for (std::size_t num_threads = 1; num_threads <= 8; ++num_threads)
+    {
+      stations::StationOptions options;
+      options.set_num_threads(num_threads);
+      REQUIRE(stations::read_integers_in_parallel(file.file_name, std::move(options)) == expected);
+    }
+  }
+}
@@ -0,0 +1,138 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::min
+#include <deque> // std::deque
+#include <limits> // std::numeric_limits
+#include <list> // std::list
+#include <numeric> // std::accumulate
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+
+#include <stations/numeric.hpp> // stations::reduce, stations::transform_reduce
+
+
+/*****************************
+ * Reducing empty containers *
+ *****************************/
+template <typename T>
+void
+check_empty_reduce()
+{
+  T ints;
+  REQUIRE(stations::reduce(ints.begin(), ints.end()) == 0);
+  REQUIRE(stations::reduce(ints.begin(), ints.end(), 42) == 42);
+}
+
+
+TEST_CASE("Reducing empty containers")
+{
+  SECTION("Empty vector")
+    check_empty_reduce<std::vector<int> >();
+
+  SECTION("Empty list")
+    check_empty_reduce<std::list<int> >();
+
+  SECTION("Empty deque")
+    check_empty_reduce<std::deque<int> >();
+}
+
+
+/***************************
+ * Reducing with operators *
+ **************************/
+template <typename T>
+void
+check_sum(std::size_t const num_threads)
+{
+  std::vector<int> const random_ints = stations_internal::get_random_ints<std::vector<int> >(100000);
+  T ints(random_ints.begin(), random_ints.end());
+  long const expected_sum = std::accumulate(ints.begin(), ints.end(), 0l);
+
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  REQUIRE(stations::reduce(std::move(options), ints.begin(), ints.end(), 0l, std::plus<long>()) == expected_sum);
+}
+
+
+TEST_CASE("Reducing with operators")
+{
+  SECTION("Sum of a vector with one thread")
+    check_sum<std::vector<int> >(1);
+
+  SECTION("Sum of a vector with three threads")
+    check_sum<std::vector<int> >(3);
+
+  SECTION("Sum of a list with four threads")
+    check_sum<std::list<int> >(4);
+
+  SECTION("Minimum")
+  {
+    std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(100000);
+    int const expected_min = *std::min_element(ints.begin(), ints.end());
+    REQUIRE(stations::reduce(ints.begin(), ints.end(), std::numeric_limits<int>::max(),
+                             [](int a, int b){return std::min(a, b);}) == expected_min);
+  }
+
+  SECTION("More threads than elements")
+  {
+    std::vector<int> ints = {1, 2, 3};
+    stations::StationOptions options;
+    options.set_num_threads(8);
+    REQUIRE(stations::reduce(std::move(options), ints.begin(), ints.end(), 0, std::plus<int>()) == 6);
+  }
+
+  SECTION("Non-commutative operator keeps the order")
+  {
+    std::vector<std::string> letters;
+
+    for (char c = 'a'; c <= 'z'; ++c)
+      letters.push_back(std::string(1, c));
+
+    stations::StationOptions options;
+    options.set_num_threads(4);
+    REQUIRE(stations::reduce(std::move(options), letters.begin(), letters.end(), std::string(">"),
+                             std::plus<std::string>()) == ">abcdefghijklmnopqrstuvwxyz");
+  }
+}
+
+
+/*****************************
+ * Transforming and reducing *
+ ****************************/
+TEST_CASE("Transforming and reducing")
+{
+  std::vector<int> const ints = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+  SECTION("Sum of squares")
+  {
+    REQUIRE(stations::transform_reduce(ints.begin(), ints.end(), 0l, std::plus<long>(),
+                                       [](int i){return static_cast<long>(i) * i;}) == 385);
+  }
+
+  SECTION("Histogram of odd and even numbers")
+  {
+    using Histogram = std::vector<std::size_t>;
+
+    stations::StationOptions options;
+    options.set_num_threads(3);
+    Histogram const histogram = stations::transform_reduce(
+      std::move(options), ints.begin(), ints.end(), Histogram(2, 0),
+      [](Histogram a, Histogram const & b)
+      {
+        a[0] += b[0];
+        a[1] += b[1];
+        return a;
+      },
+      [](int i)
+      {
+        Histogram h(2, 0);
+        ++h[i % 2];
+        return h;
+      });
+
+    REQUIRE(histogram[0] == 5);
+    REQUIRE(histogram[1] == 5);
+  }
+}
@@ -0,0 +1,196 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::copy_if, std::remove_if, std::stable_partition
+#include <deque> // std::deque
+#include <list> // std::list
+#include <memory> // std::unique_ptr
+#include <string> // std::string, std::to_string
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+
+#include <stations/algorithm.hpp> // stations::copy_if, stations::partition_copy, stations::partition, stations::remove_if
+
+
+namespace
+{
+
+bool
+is_even(int const i)
+{
+  return i % 2 == 0;
+}
+
+
+stations::StationOptions
+get_options(std::size_t const num_threads, std::size_t const chunk_size)
+{
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  return options;
+}
+
+
+/** An element which cannot be default constructed and owns memory, so the buffers must construct and destroy it. */
+struct Named
+{
+  explicit Named(int const _value)
+    : value(_value)
+    , name(std::to_string(_value))
+  {}
+
+  int value;
+  std::string name;
+};
+
+
+} // anon namespace
+
+
+/*************************
+ * Copying some elements *
+ ************************/
+template <typename T>
+void
+check_copy_if(std::size_t const num_threads, std::size_t const chunk_size)
+{
+  std::vector<int> const random_ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+  T ints(random_ints.begin(), random_ints.end());
+  std::vector<int> expected_evens;
+  std::copy_if(ints.begin(), ints.end(), std::back_inserter(expected_evens), is_even);
+
+  std::vector<int> evens(ints.size());
+  evens.erase(stations::copy_if(get_options(num_threads, chunk_size), ints.begin(), ints.end(), evens.begin(),
+                                is_even), evens.end());
+  REQUIRE(evens == expected_evens);
+}
+
+
+TEST_CASE("Copying the elements which match a predicate")
+{
+  SECTION("Empty vector")
+  {
+    std::vector<int> ints;
+    std::vector<int> out;
+    REQUIRE(stations::copy_if(ints.begin(), ints.end(), out.begin(), is_even) == out.begin());
+  }
+
+  SECTION("Vector split evenly")
+    check_copy_if<std::vector<int> >(3, 0);
+
+  SECTION("Vector in chunks")
+    check_copy_if<std::vector<int> >(4, 333);
+
+  SECTION("List in chunks")
+    check_copy_if<std::list<int> >(2, 1000);
+
+  SECTION("Deque with more threads than elements")
+  {
+    std::deque<int> ints = {1, 2, 3};
+    std::vector<int> out(3);
+    REQUIRE(stations::copy_if(get_options(8, 0), ints.begin(), ints.end(), out.begin(), is_even) == out.begin() + 1);
+    REQUIRE(out[0] == 2);
+  }
+}
+
+
+TEST_CASE("Copying elements to two outputs with partition_copy")
+{
+  std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+  std::vector<int> evens(ints.size());
+  std::list<int> odds(ints.size());
+
+  auto ends = stations::partition_copy(get_options(3, 100), ints.begin(), ints.end(), evens.begin(), odds.begin(),
+                                       is_even);
+  evens.erase(ends.first, evens.end());
+  odds.erase(ends.second, odds.end());
+
+  std::vector<int> expected_evens;
+  std::list<int> expected_odds;
+  std::copy_if(ints.begin(), ints.end(), std::back_inserter(expected_evens), is_even);
+  std::copy_if(ints.begin(), ints.end(), std::back_inserter(expected_odds), [](int i){return !is_even(i);});
+
+  REQUIRE(evens == expected_evens);
+  REQUIRE(odds == expected_odds);
+}
+
+
+/**************************************
+ * Removing and partitioning in place *
+ *************************************/
+TEST_CASE("Removing elements with remove_if")
+{
+  std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+  std::vector<int> expected_ints = ints;
+  expected_ints.erase(std::remove_if(expected_ints.begin(), expected_ints.end(), is_even), expected_ints.end());
+
+  SECTION("Vector split evenly")
+  {
+    ints.erase(stations::remove_if(get_options(3, 0), ints.begin(), ints.end(), is_even), ints.end());
+    REQUIRE(ints == expected_ints);
+  }
+
+  SECTION("Vector in chunks")
+  {
+    ints.erase(stations::remove_if(get_options(4, 99), ints.begin(), ints.end(), is_even), ints.end());
+    REQUIRE(ints == expected_ints);
+  }
+
+  SECTION("Move-only elements")
+  {
+    std::vector<std::unique_ptr<int> > pointers;
+
+    for (int i = 0; i < 100; ++i)
+      pointers.push_back(std::unique_ptr<int>(new int(i)));
+
+    pointers.erase(stations::remove_if(get_options(2, 10), pointers.begin(), pointers.end(),
+                                       [](std::unique_ptr<int> const & p){return *p % 3 != 0;}), pointers.end());
+
+    REQUIRE(pointers.size() == 34);
+    REQUIRE(*pointers[1] == 3);
+    REQUIRE(*pointers.back() == 99);
+  }
+}
+
+
+TEST_CASE("Stable partitioning with partition")
+{
+  std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+  std::vector<int> expected_ints = ints;
+  auto const expected_middle = std::stable_partition(expected_ints.begin(), expected_ints.end(), is_even);
+
+  auto const middle = stations::partition(get_options(3, 500), ints.begin(), ints.end(), is_even);
+  REQUIRE(middle - ints.begin() == expected_middle - expected_ints.begin());
+  REQUIRE(ints == expected_ints);
+}
+
+
+TEST_CASE("Partitioning and removing elements without a default constructor")
+{
+  std::vector<Named> elements;
+
+  for (int i = 0; i < 1000; ++i)
+    elements.push_back(Named(i));
+
+  auto const is_even_named = [](Named const & element){return is_even(element.value);};
+
+  SECTION("Partition")
+  {
+    auto const middle = stations::partition(get_options(3, 100), elements.begin(), elements.end(), is_even_named);
+    REQUIRE(middle - elements.begin() == 500);
+    REQUIRE(elements[1].value == 2);
+    REQUIRE(elements[1].name == "2");
+    REQUIRE(elements.back().value == 999);
+    REQUIRE(elements.back().name == "999");
+  }
+
+  SECTION("Remove if")
+  {
+    elements.erase(stations::remove_if(get_options(3, 100), elements.begin(), elements.end(), is_even_named),
+                   elements.end());
+    REQUIRE(elements.size() == 500);
+    REQUIRE(elements.front().name == "1");
+    REQUIRE(elements.back().name == "999");
+  }
+}
@@ -0,0 +1,164 @@
+#include <catch.hpp>
+
+#include <atomic> // std::atomic
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <stations/internal/ring_buffer.hpp> // stations_internal::RingBuffer
+
+
+TEST_CASE("next_power_of_two function")
+{
+  REQUIRE(stations_internal::next_power_of_two(0u) == 1);
+  REQUIRE(stations_internal::next_power_of_two(1u) == 1);
+  REQUIRE(stations_internal::next_power_of_two(2u) == 2);
+  REQUIRE(stations_internal::next_power_of_two(3u) == 4);
+  REQUIRE(stations_internal::next_power_of_two(8u) == 8);
+  REQUIRE(stations_internal::next_power_of_two(9u) == 16);
+}
+
+
+TEST_CASE("Ring buffer with a single thread")
+{
+  stations_internal::RingBuffer<int> ring(3);
+  REQUIRE(ring.capacity() == 4);
+  int item = 0;
+
+  SECTION("Empty buffer")
+  {
+    REQUIRE(!ring.try_pop(item));
+  }
+
+  SECTION("Buffer with a single slot requested")
+  {
+    stations_internal::RingBuffer<int> small_ring(1);
+    REQUIRE(small_ring.capacity() == 2); // A single slot cannot tell full from empty
+    int pushed = 1;
+    REQUIRE(small_ring.try_push(pushed));
+    REQUIRE(small_ring.try_push(pushed));
+    REQUIRE(!small_ring.try_push(pushed));
+  }
+
+  SECTION("Full buffer")
+  {
+    for (int i = 0; i < 4; ++i)
+      REQUIRE(ring.try_push(i));
+
+    item = 100;
+    REQUIRE(!ring.try_push(item));
+    REQUIRE(item == 100); // Failed pushes do not touch the item
+
+    for (int i = 0; i < 4; ++i)
+    {
+      REQUIRE(ring.try_pop(item));
+      REQUIRE(item == i);
+    }
+
+    REQUIRE(!ring.try_pop(item));
+  }
+
+  SECTION("Slots are reused in order")
+  {
+    for (int i = 0; i < 1000; ++i)
+    {
+      int pushed = i;
+      REQUIRE(ring.try_push(pushed));
+      REQUIRE(ring.try_pop(item));
+      REQUIRE(item == i);
+    }
+  }
+}
+
+
+TEST_CASE("Ring buffer with multiple producers")
+{
+  std::size_t const PRODUCERS = 4;
+  long const ITEMS_PER_PRODUCER = 10000;
+  stations_internal::RingBuffer<long> ring(16);
+  std::vector<std::thread> producers;
+
+  for (std::size_t p = 0; p < PRODUCERS; ++p)
+  {
+    producers.push_back(std::thread([&ring, ITEMS_PER_PRODUCER]
+      {
+        for (long i = 1; i <= ITEMS_PER_PRODUCER; ++i)
+        {
+          long item = i;
+
+          while (!ring.try_push(item))
+            std::this_thread::yield();
+        }
+      }));
+  }
+
+  long sum = 0;
+  long item;
+
+  for (std::size_t popped = 0; popped < PRODUCERS * ITEMS_PER_PRODUCER;)
+  {
+    if (ring.try_pop(item))
+    {
+      sum += item;
+      ++popped;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  for (auto & producer : producers)
+    producer.join();
+
+  REQUIRE(sum == static_cast<long>(PRODUCERS) * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2);
+  REQUIRE(!ring.try_pop(item));
+}
+
+
+TEST_CASE("Ring buffer with multiple producers and consumers")
+{
+  std::size_t const THREADS = 3;
+  long const ITEMS_PER_PRODUCER = 10000;
+  stations_internal::RingBuffer<long> ring(8);
+  std::atomic<long> sum(0);
+  std::atomic<long> popped(0);
+  std::vector<std::thread> threads;
+
+  for (std::size_t t = 0; t < THREADS; ++t)
+  {
+    threads.push_back(std::thread([&ring, ITEMS_PER_PRODUCER]
+      {
+        for (long i = 1; i <= ITEMS_PER_PRODUCER; ++i)
+        {
+          long item = i;
+
+          while (!ring.try_push(item))
+            std::this_thread::yield();
+        }
+      }));
+
+    threads.push_back(std::thread([&ring, &sum, &popped, THREADS, ITEMS_PER_PRODUCER]
+      {
+        long item;
+
+        while (popped < static_cast<long>(THREADS) * ITEMS_PER_PRODUCER)
+        {
+          if (ring.try_pop(item))
+          {
+            sum += item;
+            ++popped;
+          }
+          else
+          {
+            std::this_thread::yield();
+          }
+        }
+      }));
+  }
+
+  for (auto & thread : threads)
+    thread.join();
+
+  REQUIRE(popped == static_cast<long>(THREADS) * ITEMS_PER_PRODUCER);
+  REQUIRE(sum == static_cast<long>(THREADS) * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2);
+}
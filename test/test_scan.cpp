@@ -0,0 +1,137 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::max
+#include <cstdint> // std::uint64_t
+#include <list> // std::list
+#include <numeric> // std::partial_sum
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <stations/internal/data_simulation.hpp> // stations_internal::get_random_ints
+
+#include <stations/numeric.hpp> // stations::inclusive_scan, stations::exclusive_scan
+
+
+/*****************************
+ * Scanning empty containers *
+ ****************************/
+TEST_CASE("Scanning empty containers")
+{
+  std::vector<int> ints;
+  std::vector<int> out;
+  REQUIRE(stations::inclusive_scan(ints.begin(), ints.end(), out.begin()) == out.begin());
+  REQUIRE(stations::exclusive_scan(ints.begin(), ints.end(), out.begin(), 0) == out.begin());
+}
+
+
+/*******************
+ * Inclusive scans *
+ ******************/
+std::vector<std::uint64_t>
+get_record_lengths()
+{
+  std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(100000);
+  std::vector<std::uint64_t> lengths;
+
+  for (int const i : ints)
+    lengths.push_back(static_cast<std::uint64_t>(i) % 1000);
+
+  return lengths;
+}
+
+
+TEST_CASE("Inclusive scans")
+{
+  std::vector<std::uint64_t> lengths = get_record_lengths();
+  std::vector<std::uint64_t> expected_sums(lengths.size());
+  std::partial_sum(lengths.begin(), lengths.end(), expected_sums.begin());
+
+  SECTION("Into another vector with three threads")
+  {
+    std::vector<std::uint64_t> sums(lengths.size());
+    stations::StationOptions options;
+    options.set_num_threads(3);
+    auto it = stations::inclusive_scan(std::move(options), lengths.begin(), lengths.end(), sums.begin(),
+                                       std::plus<std::uint64_t>());
+    REQUIRE(it == sums.end());
+    REQUIRE(sums == expected_sums);
+  }
+
+  SECTION("In place in small chunks")
+  {
+    stations::StationOptions options;
+    options.set_num_threads(4);
+    options.chunk_size = 777;
+    stations::inclusive_scan(std::move(options), lengths.begin(), lengths.end(), lengths.begin(),
+                             std::plus<std::uint64_t>());
+    REQUIRE(lengths == expected_sums);
+  }
+
+  SECTION("With an initial value")
+  {
+    std::vector<std::uint64_t> sums(lengths.size());
+    stations::inclusive_scan(lengths.begin(), lengths.end(), sums.begin(), std::plus<std::uint64_t>(),
+                             static_cast<std::uint64_t>(10));
+    REQUIRE(sums.front() == lengths.front() + 10);
+    REQUIRE(sums.back() == expected_sums.back() + 10);
+  }
+
+  SECTION("List with more threads than elements")
+  {
+    std::list<int> ints = {1, 2, 3};
+    stations::StationOptions options;
+    options.set_num_threads(8);
+    stations::inclusive_scan(std::move(options), ints.begin(), ints.end(), ints.begin(), std::plus<int>());
+    REQUIRE(ints == std::list<int>({1, 3, 6}));
+  }
+
+  SECTION("Non-commutative operator")
+  {
+    std::vector<std::string> letters = {"a", "b", "c", "d", "e", "f", "g"};
+    stations::StationOptions options;
+    options.set_num_threads(3);
+    stations::inclusive_scan(std::move(options), letters.begin(), letters.end(), letters.begin(),
+                             std::plus<std::string>());
+    REQUIRE(letters.back() == "abcdefg");
+    REQUIRE(letters[3] == "abcd");
+  }
+}
+
+
+/*******************
+ * Exclusive scans *
+ ******************/
+TEST_CASE("Exclusive scans")
+{
+  std::vector<std::uint64_t> lengths = get_record_lengths();
+  std::vector<std::uint64_t> expected_offsets(lengths.size());
+  std::partial_sum(lengths.begin(), lengths.end() - 1, expected_offsets.begin() + 1);
+  expected_offsets[0] = 0;
+
+  SECTION("Offsets of records with three threads")
+  {
+    std::vector<std::uint64_t> offsets(lengths.size());
+    stations::StationOptions options;
+    options.set_num_threads(3);
+    stations::exclusive_scan(std::move(options), lengths.begin(), lengths.end(), offsets.begin(),
+                             static_cast<std::uint64_t>(0), std::plus<std::uint64_t>());
+    REQUIRE(offsets == expected_offsets);
+  }
+
+  SECTION("In place")
+  {
+    stations::exclusive_scan(lengths.begin(), lengths.end(), lengths.begin(), static_cast<std::uint64_t>(0));
+    REQUIRE(lengths == expected_offsets);
+  }
+
+  SECTION("With a custom operator")
+  {
+    std::vector<int> ints = {3, 1, 4, 1, 5, 9, 2, 6};
+    stations::StationOptions options;
+    options.set_num_threads(2);
+    options.chunk_size = 3;
+    stations::exclusive_scan(std::move(options), ints.begin(), ints.end(), ints.begin(), 0,
+                             [](int a, int b){return std::max(a, b);});
+    REQUIRE(ints == std::vector<int>({0, 3, 3, 4, 4, 5, 9, 9}));
+  }
+}
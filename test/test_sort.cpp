@@ -1,9 +1,11 @@
 #include <catch.hpp>
 
-#include <algorithm> // std::is_sorted
+#include <algorithm> // std::count, std::is_sorted, std::sort
 #include <array> // std::array
 #include <deque> // std::deque
+#include <functional> // std::greater, std::less
 #include <list> // std::list
+#include <string> // std::string, std::to_string
 #include <vector> // std::vector
 
 #include <parallel/algorithm>
@@ -147,3 +149,192 @@ TEST_CASE("Sorting large containers")
   // SECTION("Large deque of integers")
   //   check_large_ints<std::deque<int> >();
 }
+
+
+/***************************************
+ * Sorting with a parallel merge phase *
+ **************************************/
+void
+check_sort_with_options(std::size_t const num_threads, std::size_t const chunk_size, std::size_t const N)
+{
+  std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(N);
+
+  // Add some duplicates
+  for (std::size_t i = 0; i + 1 < ints.size(); i += 10)
+    ints[i + 1] = ints[i];
+
+  std::vector<int> expected_ints = ints;
+  std::sort(expected_ints.begin(), expected_ints.end());
+  std::vector<int> compared_ints = ints;
+
+  // Integers are radix sorted
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  stations::sort(std::move(options), ints.begin(), ints.end());
+  REQUIRE(ints == expected_ints);
+
+  // With a comparator the partitions are sorted and merged
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  stations::sort(std::move(options), compared_ints.begin(), compared_ints.end(), std::less<int>());
+  REQUIRE(compared_ints == expected_ints);
+}
+
+
+TEST_CASE("Sorting with different number of partitions")
+{
+  SECTION("Two threads")
+    check_sort_with_options(2, 0, 10000);
+
+  SECTION("Three threads")
+    check_sort_with_options(3, 0, 10001);
+
+  SECTION("Seven threads")
+    check_sort_with_options(7, 0, 100003);
+
+  SECTION("Many small chunks")
+    check_sort_with_options(4, 77, 10000);
+
+  SECTION("More threads than elements")
+    check_sort_with_options(8, 0, 5);
+}
+
+
+TEST_CASE("Sorting with a comparator")
+{
+  std::deque<int> ints = stations_internal::get_random_ints<std::deque<int> >(10000);
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  stations::sort(std::move(options), ints.begin(), ints.end(), std::greater<int>());
+  REQUIRE(std::is_sorted(ints.begin(), ints.end(), std::greater<int>()));
+}
+
+
+namespace
+{
+
+/** An element which cannot be default constructed and owns memory, so the merge buffer must construct and destroy it. */
+struct KeyWithName
+{
+  explicit KeyWithName(int const _key)
+    : key(_key)
+    , name(std::to_string(_key))
+  {}
+
+  bool
+  operator<(KeyWithName const & other) const
+  {
+    return key < other.key;
+  }
+
+  int key;
+  std::string name;
+};
+
+
+} // anonymous namespace
+
+
+TEST_CASE("Sorting elements without a default constructor")
+{
+  std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+  std::vector<KeyWithName> keys;
+
+  for (int const i : ints)
+    keys.push_back(KeyWithName(i));
+
+  stations::StationOptions options;
+  options.set_num_threads(4);
+  stations::sort(std::move(options), keys.begin(), keys.end());
+
+  REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+
+  for (KeyWithName const & key : keys)
+    REQUIRE(key.name == std::to_string(key.key));
+}
+
+
+template <typename T>
+void
+check_sort_with_small_buffer(std::size_t const num_threads, std::size_t const max_merge_buffer_size)
+{
+  T ints = stations_internal::get_random_ints<T>(10000);
+  std::vector<int> expected(ints.begin(), ints.end());
+  std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.max_merge_buffer_size = max_merge_buffer_size;
+  stations::sort(std::move(options), ints.begin(), ints.end(), std::greater<int>());
+  REQUIRE(std::vector<int>(ints.begin(), ints.end()) == expected);
+}
+
+
+TEST_CASE("Sorting without a merge buffer")
+{
+  SECTION("A buffer of a tenth of the range")
+  {
+    std::vector<int> ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+    stations::StationOptions options;
+    options.set_num_threads(4);
+    options.max_merge_buffer_size = 1000;
+    stations::sort(std::move(options), ints.begin(), ints.end());
+    REQUIRE(std::is_sorted(ints.begin(), ints.end()));
+  }
+
+  SECTION("Buffers of different sizes")
+  {
+    check_sort_with_small_buffer<std::vector<int> >(4, 1000);
+    check_sort_with_small_buffer<std::vector<int> >(3, 9999);
+    check_sort_with_small_buffer<std::vector<int> >(7, 100);
+    check_sort_with_small_buffer<std::deque<int> >(5, 7);
+  }
+
+  SECTION("Merging by rotations alone")
+  {
+    check_sort_with_small_buffer<std::vector<int> >(4, 0);
+    check_sort_with_small_buffer<std::vector<int> >(2, 1);
+  }
+
+  SECTION("Elements without a default constructor")
+  {
+    std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+    std::vector<KeyWithName> keys;
+
+    for (int const i : ints)
+      keys.push_back(KeyWithName(i));
+
+    stations::StationOptions options;
+    options.set_num_threads(4);
+    options.max_merge_buffer_size = 500;
+    stations::sort(std::move(options), keys.begin(), keys.end());
+    REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+
+    for (KeyWithName const & key : keys)
+      REQUIRE(key.name == std::to_string(key.key));
+  }
+}
+
+
+TEST_CASE("Sorting a vector of booleans")
+{
+  // The iterators of std::vector<bool> return proxy references, so the booleans are sorted by comparing them
+  std::vector<int> const ints = stations_internal::get_random_ints<std::vector<int> >(10000);
+  std::vector<bool> bools;
+
+  for (int const i : ints)
+    bools.push_back(i % 2 == 0);
+
+  std::size_t const num_false = std::count(bools.begin(), bools.end(), false);
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  stations::sort(std::move(options), bools.begin(), bools.end());
+
+  REQUIRE(std::is_sorted(bools.begin(), bools.end()));
+  REQUIRE(static_cast<std::size_t>(std::count(bools.begin(), bools.end(), false)) == num_false);
+
+  std::vector<bool> few_bools = {true, false, true, false};
+  stations::sort(few_bools.begin(), few_bools.end());
+  REQUIRE(few_bools == std::vector<bool>({false, false, true, true}));
+}
@@ -0,0 +1,288 @@
+#include <catch.hpp>
+
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::milliseconds
+#include <ctime> // std::clock
+#include <thread> // std::this_thread::sleep_for
+
+#include <stations/station.hpp> // stations::Station
+
+
+TEST_CASE("Station runs every job it is given")
+{
+  std::atomic<long> sum(0);
+
+  SECTION("Single thread")
+  {
+    stations::Station station(1 /*num_threads*/);
+
+    for (long i = 1; i <= 1000; ++i)
+      station.add_work([&sum](long n){sum += n;}, i);
+
+    station.join();
+    REQUIRE(sum == 500500);
+  }
+
+  SECTION("Four threads")
+  {
+    stations::Station station(4 /*num_threads*/, 3 /*max_queue_size*/);
+
+    for (long i = 1; i <= 100000; ++i)
+      station.add_work([&sum](long n){sum += n;}, i);
+
+    station.join();
+    REQUIRE(sum == 5000050000);
+  }
+
+  SECTION("Jobs added to specific threads")
+  {
+    stations::Station station(3 /*num_threads*/, 1 /*max_queue_size*/);
+
+    for (long i = 1; i <= 1000; ++i)
+      station.add_to_thread(i, [&sum](long n){sum += n;}, i);
+
+    station.join();
+    REQUIRE(sum == 500500);
+  }
+}
+
+
+void
+check_wait_strategy(stations::WAIT_STRATEGY const wait_strategy)
+{
+  std::atomic<long> sum(0);
+  stations::StationOptions options;
+  options.set_num_threads(4);
+  options.wait_strategy = wait_strategy;
+  stations::Station station(options);
+
+  // Give the workers time to go idle before they get any work
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  for (long i = 1; i <= 10000; ++i)
+  {
+    station.add_work([&sum](long n){sum += n;}, i);
+
+    // Let the workers go idle again now and then
+    if (i % 1000 == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  station.join();
+  REQUIRE(sum == 50005000);
+}
+
+
+TEST_CASE("Workers wake up after being idle")
+{
+  SECTION("Low latency")
+    check_wait_strategy(stations::LOW_LATENCY);
+
+  SECTION("Balanced")
+    check_wait_strategy(stations::BALANCED);
+
+  SECTION("Power saving")
+    check_wait_strategy(stations::POWER_SAVING);
+}
+
+
+TEST_CASE("Idle workers steal jobs from busy workers")
+{
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.max_queue_size = 8;
+  options.scheduling_mode = stations::WORK_STEALING;
+  stations::Station station(options);
+  std::atomic<bool> release_blocker(false);
+  std::atomic<int> small_jobs_done(0);
+
+  // Thread 0 gets stuck on the first job, so the rest of its queue can only be run by thread 1
+  station.add_to_thread(0, [&release_blocker]{
+      while (!release_blocker)
+        std::this_thread::yield();
+    });
+
+  for (int i = 0; i < 5; ++i)
+    station.add_to_thread(0, [&small_jobs_done]{++small_jobs_done;});
+
+  for (int i = 0; i < 1000 && small_jobs_done < 5; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  REQUIRE(small_jobs_done == 5);
+  release_blocker = true;
+  station.join();
+}
+
+
+TEST_CASE("Workers sleep while a job stolen from their queue is running")
+{
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.max_queue_size = 8;
+  options.scheduling_mode = stations::WORK_STEALING;
+  options.wait_strategy = stations::POWER_SAVING;
+  bool was_stolen = false;
+
+  // Which worker runs which blocker is up to the scheduler, so repeat until thread 1 has stolen the job of thread 0
+  for (int attempt = 0; attempt < 20 && !was_stolen; ++attempt)
+  {
+    stations::Station station(options);
+    std::atomic<int> blockers_started(0);
+    std::atomic<bool> release_one(false);
+    std::atomic<bool> long_job_started(false);
+    int const released_blocker = attempt % 2;
+
+    auto blocker = [&blockers_started, &release_one, &long_job_started, released_blocker]{
+        int const index = blockers_started++;
+
+        while (!(index == released_blocker && release_one) && !long_job_started)
+          std::this_thread::yield();
+      };
+
+    // Both workers are blocked when the long job is added, and the one which is released first runs it
+    station.add_to_thread(0, blocker);
+    station.add_to_thread(1, blocker);
+
+    while (blockers_started < 2)
+      std::this_thread::yield();
+
+    station.add_to_thread(0, [&long_job_started]{
+        long_job_started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      });
+
+    std::clock_t const cpu_start = std::clock();
+    release_one = true;
+    station.wait();
+
+    // Every thread sleeps while the long job runs, instead of polling
+    double const cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    station.join();
+    was_stolen = station.get_stats().workers[1].tasks_executed == 2;
+
+    if (was_stolen)
+      REQUIRE(cpu_seconds < 0.1);
+  }
+
+  REQUIRE(was_stolen);
+}
+
+
+void
+check_boss_thread_mode(stations::BOSS_THREAD_MODE const boss_thread_mode)
+{
+  std::atomic<long> sum(0);
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.boss_thread_mode = boss_thread_mode;
+  options.queue_capacity = 4;
+  stations::Station station(options);
+  std::thread::id const boss_id = std::this_thread::get_id();
+  std::atomic<bool> boss_worked(false);
+
+  for (long i = 1; i <= 10000; ++i)
+  {
+    station.add_work([&sum, &boss_worked, boss_id](long n){
+        if (std::this_thread::get_id() == boss_id)
+          boss_worked = true;
+
+        sum += n;
+      }, i);
+  }
+
+  station.join();
+  REQUIRE(sum == 50005000);
+
+  // Only the hard working boss runs jobs itself
+  if (boss_thread_mode != stations::HARD_WORKING_BOSS)
+    REQUIRE(!boss_worked);
+}
+
+
+TEST_CASE("Boss thread modes")
+{
+  SECTION("Hard working boss")
+    check_boss_thread_mode(stations::HARD_WORKING_BOSS);
+
+  SECTION("Patient boss")
+    check_boss_thread_mode(stations::PATIENT_BOSS);
+
+  SECTION("Organized boss")
+    check_boss_thread_mode(stations::ORGANIZED_BOSS);
+}
+
+
+TEST_CASE("Patient boss waits for room in the queues")
+{
+  stations::StationOptions options;
+  options.set_num_threads(2);
+  options.max_queue_size = 1;
+  options.boss_thread_mode = stations::PATIENT_BOSS;
+  stations::Station station(options);
+  std::atomic<bool> release_blocker(false);
+  std::atomic<bool> second_job_added(false);
+
+  station.add_work([&release_blocker]{
+      while (!release_blocker)
+        std::this_thread::yield();
+    });
+
+  // The only queue is full, so adding the next job blocks until the first one is done
+  std::thread boss([&station, &second_job_added]{
+      station.add_work([]{});
+      second_job_added = true;
+    });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  REQUIRE(!second_job_added);
+  release_blocker = true;
+  boss.join();
+  REQUIRE(second_job_added);
+  station.join();
+}
+
+
+TEST_CASE("Stations count what their threads have done")
+{
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.max_queue_size = 1;
+  stations::Station station(options);
+
+  for (int i = 0; i < 50; ++i)
+    station.add_work([]{std::this_thread::sleep_for(std::chrono::microseconds(100));});
+
+  station.wait();
+  stations::StationStats const stats = station.get_stats();
+  REQUIRE(stats.workers.size() == 2);
+
+  // The boss only runs a job itself after finding the queues full
+  stations::ThreadStats const total = stats.get_worker_total();
+  REQUIRE(total.tasks_executed + stats.boss_inline_executions == 50);
+  REQUIRE(stats.queue_full_events >= stats.boss_inline_executions);
+  REQUIRE(total.busy_ns >= total.tasks_executed * 100000);
+  REQUIRE(total.sleep_ns <= total.idle_ns);
+
+  station.join();
+}
+
+
+TEST_CASE("Stations add up the counts of every thread which adds work")
+{
+  // Without workers every job runs on the thread which adds it
+  stations::Station station(1 /*num_threads*/);
+  std::thread other_boss([&station]{
+      for (int i = 0; i < 30; ++i)
+        station.add_work([]{});
+    });
+
+  for (int i = 0; i < 20; ++i)
+    station.add_work([]{});
+
+  other_boss.join();
+  stations::StationStats const stats = station.get_stats();
+  REQUIRE(stats.workers.size() == 0);
+  REQUIRE(stats.boss_inline_executions == 50);
+  REQUIRE(stats.queue_full_events == 0);
+  station.join();
+}
@@ -0,0 +1,134 @@
+#include <catch.hpp>
+
+#include <atomic> // std::atomic
+#include <cstdlib> // std::malloc, std::free
+#include <memory> // std::shared_ptr, std::unique_ptr
+#include <new> // std::bad_alloc
+#include <vector> // std::vector
+
+#include <stations/station.hpp> // stations::Station
+#include <stations/future.hpp> // stations::Future, stations::ResultSlot
+#include <stations/task.hpp> // stations::Task
+
+
+/** Counts every allocation in the test program, so we can check that adding work does not allocate. */
+static std::atomic<std::size_t> num_allocations(0);
+
+
+void *
+operator new(std::size_t size)
+{
+  ++num_allocations;
+  void * ptr = std::malloc(size);
+
+  if (!ptr)
+    throw std::bad_alloc();
+
+  return ptr;
+}
+
+
+void
+operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+
+TEST_CASE("Tasks run and release their jobs")
+{
+  std::shared_ptr<int> value = std::make_shared<int>(1);
+  stations::Task task([value]{++(*value);});
+  REQUIRE(value.use_count() == 2);
+  REQUIRE(static_cast<bool>(task));
+
+  SECTION("Run")
+  {
+    task();
+    REQUIRE(*value == 2);
+  }
+
+  SECTION("Move")
+  {
+    stations::Task moved_task(std::move(task));
+    REQUIRE(!task);
+    REQUIRE(value.use_count() == 2);
+    moved_task();
+    REQUIRE(*value == 2);
+
+    task = std::move(moved_task);
+    REQUIRE(!moved_task);
+    task();
+    REQUIRE(*value == 3);
+  }
+
+  SECTION("Reset")
+  {
+    task.reset();
+    REQUIRE(!task);
+    REQUIRE(value.use_count() == 1);
+  }
+}
+
+
+TEST_CASE("Bound jobs forward their arguments")
+{
+  std::atomic<int> sum(0);
+  stations::Station station(3 /*num_threads*/);
+
+  // Move-only arguments can be given to jobs
+  for (int i = 1; i <= 100; ++i)
+  {
+    std::unique_ptr<int> value(new int(i));
+    station.add_work([&sum](std::unique_ptr<int> v){sum += *v;}, std::move(value));
+    REQUIRE(!value);
+  }
+
+  station.join();
+  REQUIRE(sum == 5050);
+}
+
+
+TEST_CASE("Adding work does not allocate")
+{
+  std::atomic<long> sum(0);
+  std::shared_ptr<long> factor = std::make_shared<long>(2);
+  stations::Station station(3 /*num_threads*/, 4 /*max_queue_size*/);
+
+  std::size_t const allocations_before = num_allocations;
+
+  for (long i = 1; i <= 10000; ++i)
+    station.add_work([&sum](long n, std::shared_ptr<long> f){sum += n * *f;}, i, factor);
+
+  station.wait();
+  std::size_t const allocations_after = num_allocations;
+
+  station.join();
+  REQUIRE(sum == 100010000);
+  REQUIRE(allocations_after == allocations_before);
+}
+
+
+TEST_CASE("Adding work with a result does not allocate")
+{
+  std::vector<stations::ResultSlot<long> > slots(1000);
+  std::vector<stations::Future<long> > futures;
+  futures.reserve(slots.size());
+  stations::Station station(3 /*num_threads*/, 4 /*max_queue_size*/);
+
+  std::size_t const allocations_before = num_allocations;
+
+  for (long i = 0; i < static_cast<long>(slots.size()); ++i)
+    futures.push_back(station.add_work_with_result(slots[i], [](long n){return n * n;}, i));
+
+  long sum = 0;
+
+  for (auto const & future : futures)
+    sum += future.get();
+
+  std::size_t const allocations_after = num_allocations;
+
+  station.join();
+  REQUIRE(sum == 332833500);
+  REQUIRE(allocations_after == allocations_before);
+}
@@ -0,0 +1,132 @@
+#include <catch.hpp>
+
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+#include <vector> // std::vector
+
+#include <stations/station.hpp> // stations::Station
+#include <stations/task_graph.hpp> // stations::TaskGraph
+#include <stations/thread_pool.hpp> // stations::PooledStation
+
+
+/****************************
+ * Building the task graphs *
+ ****************************/
+TEST_CASE("Cycles in the dependencies are found")
+{
+  stations::TaskGraph graph;
+  std::atomic<int> num_runs(0);
+  std::size_t const a = graph.add_task([&num_runs]{++num_runs;});
+  std::size_t const b = graph.add_task([&num_runs]{++num_runs;});
+  std::size_t const c = graph.add_task([&num_runs]{++num_runs;});
+  graph.add_dependency(b, a);
+  graph.add_dependency(c, b);
+  REQUIRE(graph.size() == 3);
+  REQUIRE(!graph.has_cycle());
+
+  graph.add_dependency(a, c);
+  REQUIRE(graph.has_cycle());
+
+  stations::Station station(2 /*num_threads*/);
+  REQUIRE(!graph.run(station));
+  REQUIRE(num_runs == 0);
+  station.join();
+}
+
+
+TEST_CASE("An empty task graph runs nothing")
+{
+  stations::TaskGraph graph;
+  stations::Station station(2 /*num_threads*/);
+  REQUIRE(graph.run(station));
+  station.join();
+}
+
+
+/***************************
+ * Running the task graphs *
+ ***************************/
+/** Builds layers of tasks where every task depends on every task of the previous layer, runs the graph and checks
+ *  that no task started before its dependencies had finished.
+ */
+template <typename TStation>
+void
+run_layers(TStation & station)
+{
+  std::size_t const num_layers = 20;
+  std::size_t const layer_size = 8;
+  std::vector<std::atomic<bool> > finished(num_layers * layer_size);
+  std::atomic<int> num_too_early(0);
+  stations::TaskGraph graph;
+
+  for (auto & f : finished)
+    f = false;
+
+  for (std::size_t l = 0; l < num_layers; ++l)
+  {
+    for (std::size_t i = 0; i < layer_size; ++i)
+    {
+      std::size_t const t = graph.add_task([&finished, &num_too_early](std::size_t const l, std::size_t const t)
+        {
+          for (std::size_t d = l * layer_size - layer_size; l > 0 && d < l * layer_size; ++d)
+          {
+            if (!finished[d])
+              ++num_too_early;
+          }
+
+          finished[t] = true;
+        }, l, l * layer_size + i);
+
+      for (std::size_t d = 0; l > 0 && d < layer_size; ++d)
+        graph.add_dependency(t, (l - 1) * layer_size + d);
+    }
+  }
+
+  REQUIRE(graph.run(station));
+  station.join();
+  REQUIRE(num_too_early == 0);
+
+  for (auto const & f : finished)
+    REQUIRE(f);
+}
+
+
+TEST_CASE("Tasks run after all their dependencies")
+{
+  for (std::size_t num_threads = 1; num_threads <= 4; num_threads *= 2)
+  {
+    {
+      stations::Station station(num_threads);
+      run_layers(station);
+    }
+
+    {
+      stations::StationOptions options;
+      options.set_num_threads(num_threads);
+      stations::PooledStation station(options);
+      run_layers(station);
+    }
+  }
+}
+
+
+TEST_CASE("Diamond shaped dependencies")
+{
+  std::vector<int> values(4, 0);
+  stations::TaskGraph graph;
+  std::size_t const top = graph.add_task([&values]{values[0] = 1;});
+  std::size_t const left = graph.add_task([&values]{values[1] = values[0] + 1;});
+  std::size_t const right = graph.add_task([&values]{values[2] = values[0] + 2;});
+  std::size_t const bottom = graph.add_task([&values]{values[3] = values[1] + values[2];});
+  graph.add_dependency(left, top);
+  graph.add_dependency(right, top);
+  graph.add_dependency(bottom, left);
+  graph.add_dependency(bottom, right);
+
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  stations::PooledStation station(options);
+  REQUIRE(graph.run(station));
+  station.join();
+  REQUIRE(values == std::vector<int>({1, 2, 3, 5}));
+}
@@ -0,0 +1,202 @@
+#include <catch.hpp>
+
+#include <atomic> // std::atomic
+#include <iostream> // std::cout
+#include <sstream> // std::ostringstream
+#include <string> // std::string
+#include <thread> // std::thread, std::this_thread::yield
+#include <vector> // std::vector
+
+#include <stations/algorithm.hpp> // stations::count_if, stations::for_each
+#include <stations/thread_pool.hpp> // stations::PooledStation
+
+
+TEST_CASE("Station can wait for its work without stopping the workers")
+{
+  std::atomic<long> sum(0);
+  stations::StationOptions options;
+  options.set_num_threads(4);
+
+  SECTION("Static scheduling")
+    options.scheduling_mode = stations::STATIC_SCHEDULING;
+
+  SECTION("Work stealing")
+    options.scheduling_mode = stations::WORK_STEALING;
+
+  stations::Station station(options);
+
+  for (long round = 1; round <= 3; ++round)
+  {
+    for (long i = 1; i <= 1000; ++i)
+      station.add_work([&sum](long n){sum += n;}, i);
+
+    station.wait();
+    REQUIRE(sum == round * 500500);
+  }
+
+  station.join();
+}
+
+
+TEST_CASE("Pooled stations reuse the same station")
+{
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  stations::Station * first_station = nullptr;
+
+  {
+    stations::PooledStation pooled_station(options);
+
+    // Another station with the same options cannot get the pool while it is in use
+    stations::PooledStation busy_pool_station(options);
+    REQUIRE(pooled_station.is_pooled() != busy_pool_station.is_pooled());
+    first_station = &(pooled_station.is_pooled() ? pooled_station : busy_pool_station).get_station();
+  }
+
+  stations::PooledStation pooled_station(options);
+  REQUIRE(pooled_station.is_pooled());
+  REQUIRE(&pooled_station.get_station() == first_station);
+
+  options.use_thread_pool = false;
+  stations::PooledStation own_station(options);
+  REQUIRE(!own_station.is_pooled());
+}
+
+
+TEST_CASE("Algorithms can run inside jobs of pooled algorithms")
+{
+  std::vector<int> ints(1000);
+
+  for (int i = 0; i < static_cast<int>(ints.size()); ++i)
+    ints[i] = i;
+
+  std::vector<std::vector<int> > rows(10, ints);
+  std::vector<std::size_t> counts(rows.size(), 0);
+
+  // With one thread every job runs on the calling thread, which already holds the pool
+  stations::StationOptions options;
+  options.set_num_threads(1);
+  stations::for_each(std::move(options), rows.begin(), rows.end(), [&rows, &counts](std::vector<int> const & row)
+    {
+      stations::StationOptions inner_options;
+      inner_options.set_num_threads(1);
+      counts[&row - rows.data()] = stations::count_if(std::move(inner_options), row.begin(), row.end(),
+                                                      [](int i){return i % 2 == 0;});
+    });
+
+  for (std::size_t const count : counts)
+    REQUIRE(count == 500);
+}
+
+
+TEST_CASE("Pooled stations have the options they were asked for")
+{
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  stations::Station * first_station = nullptr;
+
+  {
+    stations::PooledStation pooled_station(options);
+    REQUIRE(pooled_station.is_pooled());
+    first_station = &pooled_station.get_station();
+  }
+
+  // Options which only the algorithms read give the same station
+  options.chunk_size = 100;
+
+  {
+    stations::PooledStation pooled_station(options);
+    REQUIRE(&pooled_station.get_station() == first_station);
+  }
+
+  stations::StationOptions other_options;
+  other_options.set_num_threads(3);
+  other_options.max_queue_size = 5;
+  other_options.boss_thread_mode = stations::PATIENT_BOSS;
+
+  {
+    stations::PooledStation pooled_station(other_options);
+    REQUIRE(pooled_station.is_pooled());
+    REQUIRE(&pooled_station.get_station() != first_station);
+    REQUIRE(pooled_station.get_station().options.max_queue_size == 5);
+    REQUIRE(pooled_station.get_station().options.boss_thread_mode == stations::PATIENT_BOSS);
+  }
+
+  stations::PooledStation pooled_station(options);
+  REQUIRE(&pooled_station.get_station() == first_station);
+  REQUIRE(pooled_station.get_station().options.max_queue_size == options.max_queue_size);
+}
+
+
+TEST_CASE("Pooled stations print their stats when they are verbose")
+{
+  std::ostringstream out;
+  std::streambuf * const cout_buffer = std::cout.rdbuf(out.rdbuf());
+
+  {
+    stations::StationOptions options;
+    options.set_num_threads(3);
+    options.verbosity = 2;
+    stations::PooledStation pooled_station(options);
+    REQUIRE(pooled_station.is_pooled());
+    pooled_station.add_work([]{});
+  }
+
+  std::cout.rdbuf(cout_buffer);
+  REQUIRE(out.str().find("[stations] Main thread processed") != std::string::npos);
+}
+
+
+TEST_CASE("Algorithms give correct results when run repeatedly on the pool")
+{
+  std::vector<int> ints(10000);
+
+  for (int i = 0; i < static_cast<int>(ints.size()); ++i)
+    ints[i] = i;
+
+  for (int round = 0; round < 100; ++round)
+  {
+    stations::StationOptions options;
+    options.set_num_threads(3);
+    options.chunk_size = 100;
+    REQUIRE(stations::count_if(std::move(options), ints.begin(), ints.end(), [](int i){return i % 3 == 0;}) == 3334);
+  }
+}
+
+
+TEST_CASE("Concurrent callers with different options both get pooled stations")
+{
+  stations::StationOptions options;
+  options.set_num_threads(2);
+  stations::StationOptions other_options;
+  other_options.set_num_threads(3);
+
+  std::atomic<bool> is_other_taken(false);
+  std::atomic<bool> is_released(false);
+  bool is_other_pooled = false;
+
+  std::thread other_caller([&]{
+      stations::PooledStation other_station(other_options);
+      is_other_pooled = other_station.is_pooled();
+      is_other_taken = true;
+
+      while (!is_released)
+        std::this_thread::yield();
+    });
+
+  while (!is_other_taken)
+    std::this_thread::yield();
+
+  // The other caller holds its station, which only keeps callers with the same options out
+  {
+    stations::PooledStation station(options);
+    REQUIRE(station.is_pooled());
+
+    stations::PooledStation same_options_station(other_options);
+    REQUIRE(!same_options_station.is_pooled());
+  }
+
+  is_released = true;
+  other_caller.join();
+  REQUIRE(is_other_pooled);
+}
@@ -0,0 +1,125 @@
+#include <catch.hpp>
+
+#include <algorithm> // std::is_sorted, std::reverse
+#include <cstddef> // std::size_t
+#include <functional> // std::greater
+#include <sstream> // std::ostringstream
+#include <string> // std::string
+#include <utility> // std::move
+#include <vector> // std::vector
+
+#include <stations/algorithm.hpp> // stations::sort
+#include <stations/station.hpp> // stations::Station
+#include <stations/tracer.hpp> // stations::named, stations::write_chrome_trace, stations::clear_trace
+
+// These tests are built into their own executable, with STATIONS_TRACE defined
+
+
+namespace
+{
+
+std::string
+get_trace()
+{
+  std::ostringstream out;
+  stations::write_chrome_trace(out);
+  return out.str();
+}
+
+
+std::size_t
+count_occurrences(std::string const & str, std::string const & pattern)
+{
+  std::size_t count = 0;
+
+  for (std::size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+    ++count;
+
+  return count;
+}
+
+
+} // anonymous namespace
+
+
+/**********
+ * Tracer *
+ **********/
+TEST_CASE("Named work records a slice and returns what the work returns")
+{
+  stations::clear_trace();
+  auto work = stations::named("add \"one\"", [](int const value){return value + 1;});
+  REQUIRE(work(41) == 42);
+
+  std::string const trace = get_trace();
+  REQUIRE(trace.find("{\"traceEvents\":[") == 0);
+  REQUIRE(count_occurrences(trace, "\"name\":\"add \\\"one\\\"\",\"ph\":\"X\"") == 1);
+
+  stations::clear_trace();
+  REQUIRE(get_trace().find("\"ph\":\"X\"") == std::string::npos);
+}
+
+
+TEST_CASE("Station threads trace their tasks and the enqueues")
+{
+  stations::clear_trace();
+
+  {
+    stations::Station station(3 /*num_threads*/, 4 /*max_queue_size*/);
+
+    for (int i = 0; i < 50; ++i)
+      station.add_work(stations::named("job", [](){}));
+
+    station.join();
+  }
+
+  std::string const trace = get_trace();
+  REQUIRE(count_occurrences(trace, "\"name\":\"job\"") == 50);
+
+  // Every job ran either on a worker after it was enqueued or on the boss
+  REQUIRE(count_occurrences(trace, "\"name\":\"task\"") == count_occurrences(trace, "\"name\":\"enqueue\""));
+  REQUIRE(count_occurrences(trace, "\"name\":\"task\"") + count_occurrences(trace, "\"name\":\"boss task\"") == 50);
+  REQUIRE(count_occurrences(trace, "\"ph\":\"M\"") >= 1);
+}
+
+
+TEST_CASE("The phases of a sort show up as slices")
+{
+  std::vector<int> v;
+
+  for (int i = 0; i < 10000; ++i)
+    v.push_back((i * 7919) % 10007);
+
+  stations::clear_trace();
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.chunk_size = 1000;
+  std::vector<int> radix_v = v;
+
+  // With a comparison the partitions are sorted and then merged
+  stations::sort(std::move(options), v.begin(), v.end(), std::greater<int>());
+  REQUIRE(std::is_sorted(v.rbegin(), v.rend()));
+
+  std::string trace = get_trace();
+  REQUIRE(count_occurrences(trace, "\"name\":\"partition sort\"") >= 2);
+  REQUIRE(count_occurrences(trace, "\"name\":\"merge\"") >= 1);
+
+  // Integers are radix sorted
+  stations::clear_trace();
+  options.set_num_threads(3);
+  options.chunk_size = 1000;
+  stations::sort(std::move(options), radix_v.begin(), radix_v.end());
+  REQUIRE(std::is_sorted(radix_v.begin(), radix_v.end()));
+
+  trace = get_trace();
+  REQUIRE(count_occurrences(trace, "\"name\":\"radix histogram\"") >= 2);
+  REQUIRE(count_occurrences(trace, "\"name\":\"radix scatter\"") >= 2);
+
+  // So are they without options
+  stations::clear_trace();
+  v = radix_v;
+  std::reverse(v.begin(), v.end());
+  stations::sort(v.begin(), v.end());
+  REQUIRE(std::is_sorted(v.begin(), v.end()));
+  REQUIRE(get_trace().find("\"name\":\"radix histogram\"") != std::string::npos);
+}
@@ -0,0 +1,20 @@
+#include <vector> // std::vector
+
+#include <stations/algorithm.hpp> // stations::count
+#include <stations/tracer.hpp> // stations::trace_instant
+
+// Built with STATIONS_TRACE into its own executable. The thread pool is created before anything is traced, so its
+// workers are still alive when the static objects are destroyed at exit, and only then give their trace buffers back.
+
+
+int
+main()
+{
+  std::vector<int> ints(100000, 1);
+  stations::StationOptions options;
+  options.set_num_threads(3);
+  options.chunk_size = 1000;
+  int const num_ones = stations::count(std::move(options), ints.begin(), ints.end(), 1);
+  stations::trace_instant("counted");
+  return num_ones == 100000 ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include <catch.hpp>
+
+#include <deque> // std::deque
+#include <list> // std::list
+#include <string> // std::string, std::to_string
+#include <vector> // std::vector
+
+#include <stations/algorithm.hpp> // stations::transform
+
+
+/****************************************
+ * Transforming elements of a container *
+ ***************************************/
+template <typename T>
+void
+check_transform(std::size_t const num_threads, std::size_t const chunk_size)
+{
+  T ints;
+
+  for (int i = 0; i < 10000; ++i)
+    ints.push_back(i);
+
+  std::vector<std::string> strings(ints.size());
+  stations::StationOptions options;
+  options.set_num_threads(num_threads);
+  options.chunk_size = chunk_size;
+  auto it = stations::transform(std::move(options), ints.begin(), ints.end(), strings.begin(),
+                                [](int i){return std::to_string(i);});
+
+  REQUIRE(it == strings.end());
+
+  for (std::size_t i = 0; i < strings.size(); ++i)
+    REQUIRE(strings[i] == std::to_string(i));
+}
+
+
+TEST_CASE("Transforming elements")
+{
+  SECTION("Empty vector")
+  {
+    std::vector<int> ints;
+    std::vector<int> out;
+    REQUIRE(stations::transform(ints.begin(), ints.end(), out.begin(), [](int i){return i;}) == out.begin());
+  }
+
+  SECTION("Vector split evenly")
+    check_transform<std::vector<int> >(3, 0);
+
+  SECTION("Vector in chunks")
+    check_transform<std::vector<int> >(4, 333);
+
+  SECTION("List in chunks")
+    check_transform<std::list<int> >(2, 1000);
+
+  SECTION("Deque with more threads than elements")
+  {
+    std::deque<int> ints = {1, 2, 3};
+    stations::StationOptions options;
+    options.set_num_threads(8);
+    stations::transform(std::move(options), ints.begin(), ints.end(), ints.begin(), [](int i){return i * i;});
+    REQUIRE(ints == std::deque<int>({1, 4, 9}));
+  }
+
+  SECTION("Two ranges")
+  {
+    std::vector<int> a = {1, 2, 3, 4, 5};
+    std::list<int> b = {10, 20, 30, 40, 50};
+    std::vector<int> sums(5);
+    stations::StationOptions options;
+    options.set_num_threads(2);
+    stations::transform(std::move(options), a.begin(), a.end(), b.begin(), sums.begin(), std::plus<int>());
+    REQUIRE(sums == std::vector<int>({11, 22, 33, 44, 55}));
+  }
+}